@@ -0,0 +1,65 @@
+#include <iostream>
+#include <sys/mman.h>
+#include "cache.h"
+
+// 2^34 elements (64 GiB): addresses do not fit in 32 bits
+static const size_t N = (static_cast<size_t>(1) << 34);
+static const size_t N_CHUNKS = 64;
+static const size_t CHUNK_SIZE = 256;
+static const size_t STRIDE = (N / N_CHUNKS);
+
+typedef cache<int, true, true, 1, N, 4, 2, 16, true, 0, 0, false, 2> cache_t;
+
+template <typename T>
+	void bigvec(T &a) {
+#pragma HLS inline
+		for (size_t chunk = 0; chunk < N_CHUNKS; chunk++) {
+			for (size_t i = 0; i < CHUNK_SIZE; i++) {
+#pragma HLS pipeline
+				const size_t addr = ((chunk * STRIDE) + i);
+				a[addr] = (a[addr] + chunk);
+			}
+		}
+	}
+
+extern "C" void bigvec_top(int *a) {
+#pragma HLS INTERFACE m_axi port=a bundle=gmem0
+#pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#pragma HLS dataflow disable_start_propagation
+	cache_t a_cache(a);
+
+	cache_wrapper(bigvec<cache_t>, a_cache);
+}
+
+int main() {
+	// only the accessed pages are actually allocated
+	int * const a = static_cast<int *>(mmap(NULL, (N * sizeof(int)),
+				(PROT_READ | PROT_WRITE),
+				(MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE),
+				-1, 0));
+	if (a == MAP_FAILED) {
+		std::cerr << "cannot map main memory" << std::endl;
+		return 1;
+	}
+
+	for (size_t chunk = 0; chunk < N_CHUNKS; chunk++) {
+		for (size_t i = 0; i < CHUNK_SIZE; i++)
+			a[(chunk * STRIDE) + i] = i;
+	}
+
+	bigvec_top(a);
+
+	int ret = 0;
+	for (size_t chunk = 0; chunk < N_CHUNKS; chunk++) {
+		for (size_t i = 0; i < CHUNK_SIZE; i++) {
+			if (a[(chunk * STRIDE) + i] != static_cast<int>(i + chunk))
+				ret = 1;
+		}
+	}
+
+	munmap(a, (N * sizeof(int)));
+
+	return ret;
+}
+
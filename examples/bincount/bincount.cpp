@@ -0,0 +1,68 @@
+#include <iostream>
+#include "cache.h"
+
+static const size_t N = 256;
+static const size_t N_BINS = 10;
+
+// the counters of the bins are stored right before the samples, in the same
+// buffer: with 16 words per line, the only line of the counters covers also
+// the first samples, which must not be overwritten by its write-back
+typedef cache<int, true, true, 1, N, 4, 2, 16, true, 0, 0, false, 2, AUTO,
+	AUTO, 1, 0, 1, 2> cache_type;
+typedef cache_view<cache_type, 0> a_view_type;
+typedef cache_view<cache_type, 1> s_view_type;
+
+// each sample is replaced with its rank in its bin
+template <typename T, typename U>
+	void bincount(T &a, U &s) {
+#pragma HLS inline
+		for (size_t i = 0; i < N; i++) {
+#pragma HLS pipeline
+			const int bin = a[i];
+			const int count = s[bin];
+			s[bin] = (count + 1);
+			a[i] = count;
+		}
+	}
+
+extern "C" void bincount_top(int buf[N_BINS + N]) {
+#pragma HLS INTERFACE m_axi port=buf bundle=gmem0 depth=(N_BINS + N)
+#pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#pragma HLS dataflow disable_start_propagation
+	int * const arrays[] = {&(buf[N_BINS]), buf};
+	const size_t sizes[] = {N, N_BINS};
+	cache_type as_cache(arrays, sizes);
+	a_view_type a_view(as_cache);
+	s_view_type s_view(as_cache);
+
+	cache_wrapper(bincount<a_view_type, s_view_type>, a_view, s_view);
+
+#ifndef __SYNTHESIS__
+	printf("hit ratio = %d/%d\n", as_cache.get_n_hits(0),
+			as_cache.get_n_reqs(0));
+#endif /* __SYNTHESIS__ */
+}
+
+int main() {
+	static int buf[N_BINS + N];
+	static int buf_ref[N_BINS + N];
+
+	for (size_t i = 0; i < N_BINS; i++)
+		buf[i] = buf_ref[i] = 0;
+	for (size_t i = N_BINS; i < (N_BINS + N); i++)
+		buf[i] = buf_ref[i] = (std::rand() % N_BINS);
+
+	int *a_ref = &(buf_ref[N_BINS]);
+	int *s_ref = buf_ref;
+	bincount_top(buf);
+	bincount(a_ref, s_ref);
+
+	int ret = 0;
+	for (size_t i = 0; i < (N_BINS + N); i++) {
+		if (buf[i] != buf_ref[i])
+			ret = 1;
+	}
+
+	return ret;
+}
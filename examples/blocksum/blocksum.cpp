@@ -0,0 +1,78 @@
+#include <iostream>
+#include "cache.h"
+
+static const size_t N = 4096;
+static const size_t BLOCK_SIZE = 64;
+static const size_t N_BLOCKS = (N / BLOCK_SIZE);
+
+// the vector is summed block by block: the lines of the next block are
+// prefetched while the current one is summed, so that (timing permitting)
+// no line misses; consecutive blocks map onto different sets, so that the
+// prefetched lines evict those of the previous block
+typedef cache<int, true, false, 1, N, 8, 2, 16, true, 0, 0, false, 7, AUTO,
+	AUTO, 1, 0, 1, 1, no_set_hash, false, false, true> cache_a;
+typedef cache<int, false, true, 1, N_BLOCKS, 1, 1, 16, false, 0, 0, false, 3>
+	cache_sums;
+
+template <typename T, typename U>
+	void blocksum(T &a, U &sums) {
+#pragma HLS inline
+		a.prefetch_range(0, BLOCK_SIZE);
+		for (size_t block = 0; block < N_BLOCKS; block++) {
+			const size_t base = (block * BLOCK_SIZE);
+			if ((block + 1) < N_BLOCKS)
+				a.prefetch_range((base + BLOCK_SIZE), BLOCK_SIZE);
+
+			int sum = 0;
+			for (size_t i = 0; i < BLOCK_SIZE; i++) {
+#pragma HLS pipeline
+				sum += a[base + i];
+			}
+			sums[block] = sum;
+		}
+	}
+
+void blocksum_ref(const int *a, int *sums) {
+	for (size_t block = 0; block < N_BLOCKS; block++) {
+		sums[block] = 0;
+		for (size_t i = 0; i < BLOCK_SIZE; i++)
+			sums[block] += a[(block * BLOCK_SIZE) + i];
+	}
+}
+
+extern "C" void blocksum_top(int a[N], int sums[N_BLOCKS]) {
+#pragma HLS INTERFACE m_axi port=a bundle=gmem0 depth=N
+#pragma HLS INTERFACE m_axi port=sums bundle=gmem1 depth=N_BLOCKS
+#pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#pragma HLS dataflow disable_start_propagation
+	cache_a a_cache(a);
+	cache_sums sums_cache(sums);
+
+	cache_wrapper(blocksum<cache_a, cache_sums>, a_cache, sums_cache);
+
+#ifndef __SYNTHESIS__
+	printf("a hit ratio = %d/%d\n", a_cache.get_n_hits(0),
+			a_cache.get_n_reqs(0));
+#endif /* __SYNTHESIS__ */
+}
+
+int main() {
+	static int a[N];
+	static int sums[N_BLOCKS];
+	static int sums_ref[N_BLOCKS];
+
+	for (size_t i = 0; i < N; i++)
+		a[i] = (std::rand() % 256);
+
+	blocksum_top(a, sums);
+	blocksum_ref(a, sums_ref);
+
+	int ret = 0;
+	for (size_t block = 0; block < N_BLOCKS; block++) {
+		if (sums[block] != sums_ref[block])
+			ret = 1;
+	}
+
+	return ret;
+}
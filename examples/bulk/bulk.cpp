@@ -0,0 +1,87 @@
+#include <iostream>
+#include "cache.h"
+
+static const size_t N = 4096;
+// unaligned ranges, starting and ending within lines
+static const size_t FILL_BEGIN = 100;
+static const size_t FILL_LEN = 1000;
+static const size_t COPY_BEGIN = 517;
+static const size_t COPY_LEN = 2049;
+static const size_t REDUCE_BEGIN = 3;
+static const size_t REDUCE_LEN = 4090;
+static const int FILL_VALUE = -7;
+
+// copies require the destination cache to be of the same type
+typedef cache<int, true, true, 1, N, 4, 2, 16, true, 0, 0, false, 2, AUTO,
+	AUTO, 1, 0, 1, 1, no_set_hash, false, false, false, no_way_partition,
+	ROUND_ROBIN, true> cache_t;
+
+template <typename T>
+	void bulk(T &a, T &b, int results[2]) {
+#pragma HLS inline
+		a.fill(FILL_BEGIN, FILL_LEN, FILL_VALUE);
+		a.copy(b, COPY_BEGIN, COPY_LEN);
+		results[0] = b.template reduce<UPDATE_ADD>(REDUCE_BEGIN, REDUCE_LEN);
+		results[1] = a.template reduce<UPDATE_MIN>(REDUCE_BEGIN, REDUCE_LEN);
+	}
+
+void bulk_ref(int *a, int *b, int results[2]) {
+	for (size_t i = FILL_BEGIN; i < (FILL_BEGIN + FILL_LEN); i++)
+		a[i] = FILL_VALUE;
+	for (size_t i = COPY_BEGIN; i < (COPY_BEGIN + COPY_LEN); i++)
+		b[i] = a[i];
+
+	results[0] = 0;
+	results[1] = a[REDUCE_BEGIN];
+	for (size_t i = REDUCE_BEGIN; i < (REDUCE_BEGIN + REDUCE_LEN); i++) {
+		results[0] += b[i];
+		results[1] = std::min(results[1], a[i]);
+	}
+}
+
+extern "C" void bulk_top(int a[N], int b[N], int results[2]) {
+#pragma HLS INTERFACE m_axi port=a bundle=gmem0 depth=N
+#pragma HLS INTERFACE m_axi port=b bundle=gmem1 depth=N
+#pragma HLS INTERFACE m_axi port=results bundle=gmem2 depth=2
+#pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#pragma HLS dataflow disable_start_propagation
+	cache_t a_cache(a);
+	cache_t b_cache(b);
+
+	cache_wrapper(bulk<cache_t>, a_cache, b_cache, results);
+
+#ifndef __SYNTHESIS__
+	printf("a hit ratio = %d/%d\n", a_cache.get_n_hits(0),
+			a_cache.get_n_reqs(0));
+	printf("b hit ratio = %d/%d\n", b_cache.get_n_hits(0),
+			b_cache.get_n_reqs(0));
+#endif /* __SYNTHESIS__ */
+}
+
+int main() {
+	static int a[N];
+	static int a_ref[N];
+	static int b[N];
+	static int b_ref[N];
+	int results[2];
+	int results_ref[2];
+
+	for (size_t i = 0; i < N; i++) {
+		a[i] = a_ref[i] = (std::rand() % 256);
+		b[i] = b_ref[i] = (std::rand() % 256);
+	}
+
+	bulk_top(a, b, results);
+	bulk_ref(a_ref, b_ref, results_ref);
+
+	int ret = 0;
+	for (size_t i = 0; i < N; i++) {
+		if ((a[i] != a_ref[i]) || (b[i] != b_ref[i]))
+			ret = 1;
+	}
+	if ((results[0] != results_ref[0]) || (results[1] != results_ref[1]))
+		ret = 1;
+
+	return ret;
+}
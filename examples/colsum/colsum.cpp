@@ -0,0 +1,65 @@
+#include <iostream>
+#include "cache.h"
+
+static const size_t WIDTH = 64;
+static const size_t HEIGHT = 64;
+static const size_t N = (WIDTH * HEIGHT);
+
+// walking down a column, consecutive lines are WIDTH words apart: without
+// hashing they all map to the same set, while xor_set_hash spreads them
+// across all the sets, so that the lines of a column are still cached when
+// the following columns are summed
+typedef cache<int, true, false, 1, N, 32, 2, 4, true, 0, 0, false, 7, AUTO,
+	AUTO, 1, 0, 1, 1, xor_set_hash> cache_a;
+typedef cache<int, false, true, 1, WIDTH, 1, 1, 8, false, 0, 0, false, 3>
+	cache_sums;
+
+template <typename T, typename U>
+	void colsum(T &a, U &sums) {
+#pragma HLS inline
+		for (size_t x = 0; x < WIDTH; x++) {
+			int sum = 0;
+			for (size_t y = 0; y < HEIGHT; y++) {
+#pragma HLS pipeline
+				sum += a[(y * WIDTH) + x];
+			}
+			sums[x] = sum;
+		}
+	}
+
+extern "C" void colsum_top(int a[N], int sums[WIDTH]) {
+#pragma HLS INTERFACE m_axi port=a bundle=gmem0 depth=N
+#pragma HLS INTERFACE m_axi port=sums bundle=gmem1 depth=WIDTH
+#pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#pragma HLS dataflow disable_start_propagation
+	cache_a a_cache(a);
+	cache_sums sums_cache(sums);
+
+	cache_wrapper(colsum<cache_a, cache_sums>, a_cache, sums_cache);
+
+#ifndef __SYNTHESIS__
+	printf("a hit ratio = %d/%d\n", a_cache.get_n_hits(0),
+			a_cache.get_n_reqs(0));
+#endif /* __SYNTHESIS__ */
+}
+
+int main() {
+	static int a[N];
+	int sums[WIDTH];
+	int sums_ref[WIDTH];
+
+	for (size_t i = 0; i < N; i++)
+		a[i] = (std::rand() % 256);
+
+	colsum_top(a, sums);
+	colsum(a, sums_ref);
+
+	int ret = 0;
+	for (size_t x = 0; x < WIDTH; x++) {
+		if (sums[x] != sums_ref[x])
+			ret = 1;
+	}
+
+	return ret;
+}
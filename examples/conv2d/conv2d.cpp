@@ -15,7 +15,6 @@ static const size_t FILTER_H_SIZE = 3;
 
 static const size_t WIDTH_PADDED = (utils::ceil(WIDTH / 16.0) * 16);
 static const size_t SIZE = (WIDTH * HEIGHT);
-static const size_t SIZE_PADDED_CACHE = (1 << utils::log2_ceil(SIZE));
 static const size_t SIZE_PADDED_MANUAL = (WIDTH_PADDED * HEIGHT);
 static const size_t FILTER_SIZE = (FILTER_V_SIZE * FILTER_H_SIZE);
 static const size_t FILTER_V_SIZE_PADDED = (1 << utils::log2_ceil(FILTER_V_SIZE));
@@ -35,7 +34,8 @@ static const size_t RD_PORTS = UNROLL;
 #define COEFF_L2_SETS 1
 #endif /* COEFF_L2_SETS */
 #ifndef COEFF_L2_WAYS
-#define COEFF_L2_WAYS 1
+// the L2 cache holds the whole filter, so that it is resident
+#define COEFF_L2_WAYS (FILTER_SIZE_PADDED / COEFF_WORDS)
 #endif /* COEFF_L2_WAYS */
 #ifndef COEFF_L2_LATENCY
 #define COEFF_L2_LATENCY 3
@@ -51,16 +51,18 @@ static const size_t RD_PORTS = UNROLL;
 #define SRC_WORDS FILTER_SIZE_PADDED
 #endif /* SRC_WORDS */
 #ifndef SRC_L2_SETS
-#define SRC_L2_SETS 1
+#define SRC_L2_SETS 4
 #endif /* SRC_L2_SETS */
 #ifndef SRC_L2_WAYS
-#define SRC_L2_WAYS 1
+// the lines read by a port are found in L2 by the other ports
+#define SRC_L2_WAYS 2
 #endif /* SRC_L2_WAYS */
 #ifndef SRC_L2_LATENCY
 #define SRC_L2_LATENCY 3
 #endif /* SRC_L2_LATENCY */
 #ifndef SRC_L1_SETS
-#define SRC_L1_SETS 1
+// the L1 caches hold the window rows, so that each line is read once per port
+#define SRC_L1_SETS (1 << utils::log2_ceil((FILTER_V_SIZE * WIDTH) / SRC_WORDS))
 #endif /* SRC_L1_SETS */
 #ifndef SRC_L1_WAYS
 #define SRC_L1_WAYS 1
@@ -79,13 +81,13 @@ static const size_t RD_PORTS = UNROLL;
 #define DST_L2_LATENCY 3
 #endif /* DST_L2_LATENCY */
 
-typedef cache<char, true, false, RD_PORTS, FILTER_SIZE_PADDED, COEFF_L2_SETS,
+typedef cache<char, true, false, RD_PORTS, FILTER_SIZE, COEFF_L2_SETS,
 	COEFF_L2_WAYS, COEFF_WORDS, false, COEFF_L1_SETS, COEFF_L1_WAYS, false,
 	COEFF_L2_LATENCY> cache_coeff;
-typedef cache<unsigned char, true, false, RD_PORTS, SIZE_PADDED_CACHE,
+typedef cache<unsigned char, true, false, RD_PORTS, SIZE,
 	SRC_L2_SETS, SRC_L2_WAYS, SRC_WORDS, false, SRC_L1_SETS, SRC_L1_WAYS,
 	false, SRC_L2_LATENCY> cache_src;
-typedef cache<unsigned char, false, true, 1, SIZE_PADDED_CACHE, DST_L2_SETS,
+typedef cache<unsigned char, false, true, 1, SIZE, DST_L2_SETS,
 	DST_L2_WAYS, DST_WORDS, false, 0, 0, false, DST_L2_LATENCY> cache_dst;
 
 template <typename FILTER_TYPE, typename SRC_TYPE, typename DST_TYPE>
@@ -117,29 +119,22 @@ void convolution(FILTER_TYPE &coeffs, SRC_TYPE &src, DST_TYPE &dst) {
 
 template<>
 void convolution(cache_coeff &coeffs, cache_src &src, cache_dst &dst) {
+	// the rows of each window are read from port row % RD_PORTS, and the
+	// L1 caches keep the lines of those rows while the window slides
+	cache_2d<cache_src, WIDTH> img(src);
 Y:	for(int y=0; y<HEIGHT; ++y) {
 X:		for(int x=0; x<WIDTH; ++x) {
+#pragma HLS pipeline
+			// Read the pixel window, pixels outside of the image are 0
+			unsigned char pixels[FILTER_V_SIZE][FILTER_H_SIZE];
+			img.get_window<FILTER_V_SIZE, FILTER_H_SIZE>(
+					(x-(FILTER_H_SIZE/2)), (y-(FILTER_V_SIZE/2)), pixels);
+
 			// Apply 2D filter to the pixel window
 			int sum = 0;
-ROW:			for(int row=0; row<FILTER_V_SIZE; row += RD_PORTS) {
+ROW:			for(int row=0; row<FILTER_V_SIZE; row++) {
 COL:				for(int col=0; col<FILTER_H_SIZE; col++) {
-#pragma HLS pipeline II=1
-PORT:					for (auto port = 0; port < RD_PORTS; port++) {
-						int tmp = 0;
-						if ((row + port) < FILTER_V_SIZE) {
-							unsigned char pixel;
-							int xoffset = (x+col-(FILTER_H_SIZE/2));
-							int yoffset = (y+row+port-(FILTER_V_SIZE/2));
-							// Deal with boundary conditions : clamp pixels to 0 when outside of image 
-							if ( (xoffset<0) || (xoffset>=WIDTH) || (yoffset<0) || (yoffset>=HEIGHT) ) {
-								pixel = 0;
-							} else {
-								pixel = src.get(yoffset*WIDTH+xoffset, port);
-							}
-							tmp = pixel*coeffs.get((row+port) * FILTER_H_SIZE + col, port);
-						}
-						sum += tmp;
-					}
+					sum += pixels[row][col]*coeffs.get(row * FILTER_H_SIZE + col, row % RD_PORTS);
 				}
 			}
 
@@ -333,9 +328,9 @@ extern "C" {
 }
 
 extern "C" void conv2d_top(char *coeffs, unsigned char *src, unsigned char *dst) {
-#pragma HLS INTERFACE m_axi port=coeffs offset=slave bundle=gmem0 depth=FILTER_SIZE_PADDED
-#pragma HLS INTERFACE m_axi port=src offset=slave bundle=gmem1 depth=SIZE_PADDED_CACHE
-#pragma HLS interface m_axi port=dst offset=slave bundle=gmem2 depth=SIZE_PADDED_CACHE
+#pragma HLS INTERFACE m_axi port=coeffs offset=slave bundle=gmem0 depth=FILTER_SIZE
+#pragma HLS INTERFACE m_axi port=src offset=slave bundle=gmem1 depth=SIZE
+#pragma HLS interface m_axi port=dst offset=slave bundle=gmem2 depth=SIZE
 #pragma HLS INTERFACE ap_ctrl_hs port=return
 
 #if defined(CACHE)
@@ -378,10 +373,10 @@ int main() {
 	unsigned char *src_ref;
 	unsigned char *dst_ref;
 
-	coeffs = (char *)malloc(FILTER_SIZE_PADDED * sizeof(char));
+	coeffs = (char *)malloc(FILTER_SIZE * sizeof(char));
 #ifndef MANUAL
-	src = (unsigned char *)malloc(SIZE_PADDED_CACHE * sizeof(unsigned char));
-	dst = (unsigned char *)malloc(SIZE_PADDED_CACHE * sizeof(unsigned char));
+	src = (unsigned char *)malloc(SIZE * sizeof(unsigned char));
+	dst = (unsigned char *)malloc(SIZE * sizeof(unsigned char));
 #else
 	src = (unsigned char *)malloc(SIZE_PADDED_MANUAL * sizeof(unsigned char));
 	dst = (unsigned char *)malloc(SIZE_PADDED_MANUAL * sizeof(unsigned char));
@@ -0,0 +1,56 @@
+#include <iostream>
+#include "cache.h"
+
+static const size_t N = 4096;
+static const size_t STRIDE = 8;
+
+// every STRIDE-th element is scaled in place: with 4 sectors of 4 words
+// per line, only 2 sectors of each line are loaded, so that evicted (and
+// flushed) lines are written back with half of their sectors never loaded,
+// which must not overwrite the elements in between
+typedef cache<int, true, true, 1, N, 4, 2, 16, true, 0, 0, false, 2, AUTO,
+	AUTO, 4> cache_a;
+
+template <typename T>
+	void decimate(T &a) {
+#pragma HLS inline
+		for (size_t i = 0; i < N; i += STRIDE) {
+#pragma HLS pipeline
+			const int data = a[i];
+			a[i] = (data * 2);
+		}
+	}
+
+extern "C" void decimate_top(int a[N]) {
+#pragma HLS INTERFACE m_axi port=a bundle=gmem0 depth=N
+#pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#pragma HLS dataflow disable_start_propagation
+	cache_a a_cache(a);
+
+	cache_wrapper(decimate<cache_a>, a_cache);
+
+#ifndef __SYNTHESIS__
+	printf("a hit ratio = %d/%d\n", a_cache.get_n_hits(0),
+			a_cache.get_n_reqs(0));
+#endif /* __SYNTHESIS__ */
+}
+
+int main() {
+	static int a[N];
+	static int a_ref[N];
+
+	for (size_t i = 0; i < N; i++)
+		a[i] = a_ref[i] = (std::rand() % 256);
+
+	decimate_top(a);
+	decimate(a_ref);
+
+	int ret = 0;
+	for (size_t i = 0; i < N; i++) {
+		if (a[i] != a_ref[i])
+			ret = 1;
+	}
+
+	return ret;
+}
@@ -0,0 +1,80 @@
+#include <iostream>
+#include "cache.h"
+
+static const size_t N = 1024;
+static const size_t RD_PORTS = 4;
+
+// the reads of both vectors are issued by an address generator, running as a
+// separate process ahead of the function which consumes their responses, so
+// that misses do not stall the accumulation
+typedef cache<int, true, false, RD_PORTS, N, 2, 2, 16, false, 0, 0, false, 7>
+	cache_t;
+
+template <typename T>
+	void dotprod_addr(T &a, T &b, int &prod) {
+#pragma HLS inline
+		(void)prod;
+
+DOTPROD_ADDR_LOOP:	for (size_t i = 0; i < N; i += RD_PORTS) {
+#pragma HLS pipeline II=1
+			for (size_t port = 0; port < RD_PORTS; port++) {
+				a.issue_get((i + port), port);
+				b.issue_get((i + port), port);
+			}
+		}
+	}
+
+template <typename T>
+	void dotprod(T &a, T &b, int &prod) {
+#pragma HLS inline
+		int tmp = 0;
+
+DOTPROD_LOOP:	for (size_t i = 0; i < N; i += RD_PORTS) {
+#pragma HLS pipeline II=1
+			for (size_t port = 0; port < RD_PORTS; port++)
+				tmp += (a.collect(port) * b.collect(port));
+		}
+
+		prod = tmp;
+	}
+
+void dotprod_ref(const int *a, const int *b, int &prod) {
+	prod = 0;
+	for (size_t i = 0; i < N; i++)
+		prod += (a[i] * b[i]);
+}
+
+extern "C" void dotprod_top(int a[N], int b[N], int &prod) {
+#pragma HLS INTERFACE m_axi port=a bundle=gmem0 depth=N
+#pragma HLS INTERFACE m_axi port=b bundle=gmem1 depth=N
+#pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#pragma HLS dataflow disable_start_propagation
+	cache_t a_cache(a);
+	cache_t b_cache(b);
+
+	cache_wrapper(DECOUPLED, dotprod_addr<cache_t>, dotprod<cache_t>,
+			a_cache, b_cache, prod);
+
+#ifndef __SYNTHESIS__
+	printf("a hit ratio = %d/%d\n", a_cache.get_n_hits(0),
+			a_cache.get_n_reqs(0));
+#endif /* __SYNTHESIS__ */
+}
+
+int main() {
+	static int a[N];
+	static int b[N];
+	int prod;
+	int prod_ref;
+
+	for (size_t i = 0; i < N; i++) {
+		a[i] = (std::rand() % 256);
+		b[i] = (std::rand() % 256);
+	}
+
+	dotprod_top(a, b, prod);
+	dotprod_ref(a, b, prod_ref);
+
+	return (prod != prod_ref);
+}
@@ -0,0 +1,74 @@
+#include <iostream>
+#include "cache.h"
+
+static const size_t N = 4096;
+static const size_t TAPS = 8;
+static const size_t N_OUT = (N - TAPS + 1);
+
+static const int COEFFS[TAPS] = {1, -2, 3, -4, 4, -3, 2, -1};
+
+// the taps of each output are read with a single unaligned span, which
+// overlaps at most two lines
+typedef cache<int, true, false, 1, N, 2, 2, 16, true, 0, 0, false, 7> cache_x;
+typedef cache<int, false, true, 1, N_OUT, 1, 1, 16, false, 0, 0, false, 3>
+	cache_y;
+
+template <typename T, typename U>
+	void fir(T &x, U &y) {
+#pragma HLS inline
+		for (size_t i = 0; i < N_OUT; i++) {
+#pragma HLS pipeline
+			int span[TAPS];
+			x.template get_span<TAPS>(i, 0, span);
+			int sum = 0;
+			for (size_t tap = 0; tap < TAPS; tap++)
+				sum += (COEFFS[tap] * span[tap]);
+			y[i] = sum;
+		}
+	}
+
+void fir_ref(const int *x, int *y) {
+	for (size_t i = 0; i < N_OUT; i++) {
+		int sum = 0;
+		for (size_t tap = 0; tap < TAPS; tap++)
+			sum += (COEFFS[tap] * x[i + tap]);
+		y[i] = sum;
+	}
+}
+
+extern "C" void fir_top(int x[N], int y[N_OUT]) {
+#pragma HLS INTERFACE m_axi port=x bundle=gmem0 depth=N
+#pragma HLS INTERFACE m_axi port=y bundle=gmem1 depth=N_OUT
+#pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#pragma HLS dataflow disable_start_propagation
+	cache_x x_cache(x);
+	cache_y y_cache(y);
+
+	cache_wrapper(fir<cache_x, cache_y>, x_cache, y_cache);
+
+#ifndef __SYNTHESIS__
+	printf("x hit ratio = %d/%d\n", x_cache.get_n_hits(0),
+			x_cache.get_n_reqs(0));
+#endif /* __SYNTHESIS__ */
+}
+
+int main() {
+	static int x[N];
+	static int y[N_OUT];
+	static int y_ref[N_OUT];
+
+	for (size_t i = 0; i < N; i++)
+		x[i] = (std::rand() % 256);
+
+	fir_top(x, y);
+	fir_ref(x, y_ref);
+
+	int ret = 0;
+	for (size_t i = 0; i < N_OUT; i++) {
+		if (y[i] != y_ref[i])
+			ret = 1;
+	}
+
+	return ret;
+}
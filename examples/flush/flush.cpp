@@ -0,0 +1,76 @@
+#include <iostream>
+#include "cache.h"
+
+static const size_t N = 1024;
+static const size_t WORDS = 16;
+static const size_t N_DIRTY = 10;
+static const size_t N_CLEAN = 3;
+
+// lines written (all cached at the same time, so that they are written
+// back when the cache is stopped): runs of adjacent lines, merged in a
+// single write burst also across sets (3 to 5 and 8 to 9), and isolated
+// lines; the lines which are only read leave their sets clean
+static const size_t DIRTY_LINES[N_DIRTY] = {0, 1, 2, 3, 5, 7, 8, 9, 14, 15};
+static const size_t CLEAN_LINES[N_CLEAN] = {4, 6, 12};
+// every other word of odd lines is written
+static const size_t STEP[2] = {1, 2};
+
+typedef cache<int, true, true, 1, N, 8, 2, WORDS, true, 0, 0, false, 2>
+	cache_a;
+
+template <typename T>
+	void flush(T &a) {
+#pragma HLS inline
+		int sum = 0;
+		for (size_t i = 0; i < N_CLEAN; i++) {
+			for (size_t off = 0; off < WORDS; off++) {
+#pragma HLS pipeline
+				sum += a[(CLEAN_LINES[i] * WORDS) + off];
+			}
+		}
+
+		for (size_t i = 0; i < N_DIRTY; i++) {
+			const size_t line = DIRTY_LINES[i];
+			for (size_t off = 0; off < WORDS; off += STEP[line % 2]) {
+#pragma HLS pipeline
+				const size_t addr = ((line * WORDS) + off);
+				const int data = a[addr];
+				a[addr] = (data + sum);
+			}
+		}
+	}
+
+extern "C" void flush_top(int a[N]) {
+#pragma HLS INTERFACE m_axi port=a bundle=gmem0 depth=N
+#pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#pragma HLS dataflow disable_start_propagation
+	cache_a a_cache(a);
+
+	cache_wrapper(flush<cache_a>, a_cache);
+
+#ifndef __SYNTHESIS__
+	printf("a hit ratio = %d/%d\n", a_cache.get_n_hits(0),
+			a_cache.get_n_reqs(0));
+#endif /* __SYNTHESIS__ */
+}
+
+int main() {
+	static int a[N];
+	static int a_ref[N];
+
+	for (size_t i = 0; i < N; i++)
+		a[i] = a_ref[i] = (std::rand() % 256);
+
+	flush_top(a);
+	flush(a_ref);
+
+	// the lines are written to memory only when the cache is stopped
+	int ret = 0;
+	for (size_t i = 0; i < N; i++) {
+		if (a[i] != a_ref[i])
+			ret = 1;
+	}
+
+	return ret;
+}
@@ -0,0 +1,115 @@
+#include <iostream>
+#include "cache.h"
+
+static const size_t N = 8192;
+static const size_t BINS = 256;
+static const int MAX_VALUE = 4096;
+static const int CLIP = 24;
+
+// increment clipped to CLIP, as in contrast-limited histograms
+struct clip_update {
+	template <typename T>
+	static T apply(const T data, const T operand) {
+#pragma HLS inline
+		return (((data + operand) < CLIP) ? (data + operand) : CLIP);
+	}
+};
+
+// the histograms are updated in place by the caches (ATOMIC): the counts
+// return the rank of each sample in its bin, the sums are accumulated
+// through operator[], and the clipped counts use a custom update policy
+typedef cache<int, true, false, 1, N, 1, 1, 16, false, 0, 0, false, 7>
+	cache_in;
+typedef cache<int, false, true, 1, N, 1, 1, 16, false, 0, 0, false, 3>
+	cache_rank;
+typedef cache<int, true, true, 1, BINS, 4, 4, 16, true, 0, 0, false, 2, AUTO,
+	AUTO, 1, 0, 1, 1, no_set_hash, false, false, false, no_way_partition,
+	ROUND_ROBIN, false, true> cache_counts;
+typedef cache<int, true, true, 1, BINS, 2, 2, 16, true, 0, 0, false, 2, AUTO,
+	AUTO, 1, 0, 1, 1, no_set_hash, false, false, false, no_way_partition,
+	ROUND_ROBIN, false, true> cache_sums;
+typedef cache<int, true, true, 1, BINS, 2, 2, 16, true, 0, 0, false, 2, AUTO,
+	AUTO, 1, 0, 1, 1, no_set_hash, false, false, false, no_way_partition,
+	ROUND_ROBIN, false, true, clip_update> cache_clipped;
+
+template <typename T, typename U, typename V, typename W, typename X>
+	void histogram(T &in, U &rank, V &counts, W &sums, X &clipped) {
+#pragma HLS inline
+		for (size_t i = 0; i < N; i++) {
+#pragma HLS pipeline
+			const int value = in[i];
+			const size_t bin = (value / (MAX_VALUE / BINS));
+			rank[i] = counts.fetch_update(bin, UPDATE_ADD, 1);
+			sums[bin] += value;
+			clipped.update(bin, UPDATE_CUSTOM, 1);
+		}
+	}
+
+void histogram_ref(const int *in, int *rank, int *counts, int *sums,
+		int *clipped) {
+	for (size_t i = 0; i < N; i++) {
+		const int value = in[i];
+		const size_t bin = (value / (MAX_VALUE / BINS));
+		rank[i] = counts[bin]++;
+		sums[bin] += value;
+		clipped[bin] = clip_update::apply(clipped[bin], 1);
+	}
+}
+
+extern "C" void histogram_top(int in[N], int rank[N], int counts[BINS],
+		int sums[BINS], int clipped[BINS]) {
+#pragma HLS INTERFACE m_axi port=in bundle=gmem0 depth=N
+#pragma HLS INTERFACE m_axi port=rank bundle=gmem1 depth=N
+#pragma HLS INTERFACE m_axi port=counts bundle=gmem2 depth=BINS
+#pragma HLS INTERFACE m_axi port=sums bundle=gmem3 depth=BINS
+#pragma HLS INTERFACE m_axi port=clipped bundle=gmem4 depth=BINS
+#pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#pragma HLS dataflow disable_start_propagation
+	cache_in in_cache(in);
+	cache_rank rank_cache(rank);
+	cache_counts counts_cache(counts);
+	cache_sums sums_cache(sums);
+	cache_clipped clipped_cache(clipped);
+
+	cache_wrapper(histogram<cache_in, cache_rank, cache_counts, cache_sums,
+			cache_clipped>, in_cache, rank_cache, counts_cache,
+			sums_cache, clipped_cache);
+
+#ifndef __SYNTHESIS__
+	printf("sums hit ratio = %d/%d\n", sums_cache.get_n_hits(0),
+			sums_cache.get_n_reqs(0));
+#endif /* __SYNTHESIS__ */
+}
+
+int main() {
+	static int in[N];
+	static int rank[N];
+	static int rank_ref[N];
+	int counts[BINS] = {0};
+	int counts_ref[BINS] = {0};
+	int sums[BINS] = {0};
+	int sums_ref[BINS] = {0};
+	int clipped[BINS] = {0};
+	int clipped_ref[BINS] = {0};
+
+	for (size_t i = 0; i < N; i++)
+		in[i] = (std::rand() % MAX_VALUE);
+
+	histogram_top(in, rank, counts, sums, clipped);
+	histogram_ref(in, rank_ref, counts_ref, sums_ref, clipped_ref);
+
+	int ret = 0;
+	for (size_t i = 0; i < N; i++) {
+		if (rank[i] != rank_ref[i])
+			ret = 1;
+	}
+	for (size_t bin = 0; bin < BINS; bin++) {
+		if ((counts[bin] != counts_ref[bin]) ||
+				(sums[bin] != sums_ref[bin]) ||
+				(clipped[bin] != clipped_ref[bin]))
+			ret = 1;
+	}
+
+	return ret;
+}
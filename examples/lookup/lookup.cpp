@@ -0,0 +1,93 @@
+#include <iostream>
+#include "cache.h"
+
+static const size_t TABLE_SIZE = 4096;
+static const size_t HOT_SIZE = 256;
+static const size_t N_PHASES = 4;
+static const size_t N_LOOKUPS = 4096;
+static const size_t N = (N_PHASES * N_LOOKUPS);
+
+// in each phase most lookups fall in a hot range of the table, which is
+// locked in the cache at the beginning of the phase and unlocked at its
+// end, so that the other lookups cannot evict it: with 2 ways, the hot
+// range takes one way of each set and the other lookups share the other
+typedef cache<int, true, false, 1, TABLE_SIZE, 16, 2, 16, true, 0, 0, false,
+	7, AUTO, AUTO, 1, 0, 1, 1, no_set_hash, false, true> cache_table;
+typedef cache<int, true, false, 1, N, 1, 1, 16, false, 0, 0, false, 7>
+	cache_idx;
+typedef cache<int, false, true, 1, N, 1, 1, 16, false, 0, 0, false, 3>
+	cache_out;
+
+size_t hot_base(const size_t phase) {
+	return (phase * (TABLE_SIZE / N_PHASES));
+}
+
+template <typename T, typename U, typename V>
+	void lookup(T &table, U &idx, V &out) {
+#pragma HLS inline
+		for (size_t phase = 0; phase < N_PHASES; phase++) {
+			table.lock(hot_base(phase), HOT_SIZE);
+			for (size_t i = 0; i < N_LOOKUPS; i++) {
+#pragma HLS pipeline
+				const size_t j = ((phase * N_LOOKUPS) + i);
+				const int k = idx[j];
+				out[j] = table[k];
+			}
+			table.unlock(hot_base(phase), HOT_SIZE);
+		}
+	}
+
+void lookup_ref(const int *table, const int *idx, int *out) {
+	for (size_t j = 0; j < N; j++)
+		out[j] = table[idx[j]];
+}
+
+extern "C" void lookup_top(int table[TABLE_SIZE], int idx[N], int out[N]) {
+#pragma HLS INTERFACE m_axi port=table bundle=gmem0 depth=TABLE_SIZE
+#pragma HLS INTERFACE m_axi port=idx bundle=gmem1 depth=N
+#pragma HLS INTERFACE m_axi port=out bundle=gmem2 depth=N
+#pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#pragma HLS dataflow disable_start_propagation
+	cache_table table_cache(table);
+	cache_idx idx_cache(idx);
+	cache_out out_cache(out);
+
+	cache_wrapper(lookup<cache_table, cache_idx, cache_out>,
+			table_cache, idx_cache, out_cache);
+
+#ifndef __SYNTHESIS__
+	printf("table hit ratio = %d/%d\n", table_cache.get_n_hits(0),
+			table_cache.get_n_reqs(0));
+#endif /* __SYNTHESIS__ */
+}
+
+int main() {
+	static int table[TABLE_SIZE];
+	static int idx[N];
+	static int out[N];
+	static int out_ref[N];
+
+	for (size_t i = 0; i < TABLE_SIZE; i++)
+		table[i] = std::rand();
+
+	// 3 lookups out of 4 fall in the hot range of the phase
+	for (size_t phase = 0; phase < N_PHASES; phase++) {
+		for (size_t i = 0; i < N_LOOKUPS; i++) {
+			idx[(phase * N_LOOKUPS) + i] = ((std::rand() % 4) ?
+					(hot_base(phase) + (std::rand() % HOT_SIZE)) :
+					(std::rand() % TABLE_SIZE));
+		}
+	}
+
+	lookup_top(table, idx, out);
+	lookup_ref(table, idx, out_ref);
+
+	int ret = 0;
+	for (size_t j = 0; j < N; j++) {
+		if (out[j] != out_ref[j])
+			ret = 1;
+	}
+
+	return ret;
+}
@@ -0,0 +1,92 @@
+#include <iostream>
+#include "cache.h"
+
+static const size_t ROWS = 64;
+static const size_t COLS = 256;
+static const size_t N = (ROWS * COLS);
+static const size_t WORDS = 16;
+
+// the hint used to stream the matrix: with NO_ALLOCATE its lines bypass the
+// cache, so that the vector, which fills the cache exactly, is loaded once;
+// with INSERT_MRU each line of the matrix evicts a line of the vector
+#ifndef A_HINT
+#define A_HINT NO_ALLOCATE
+#endif /* A_HINT */
+
+// the matrix and the vector share a direct-mapped cache
+typedef cache<int, true, false, 1, N, (COLS / WORDS), 1, WORDS, false, 0, 0,
+	false, 7, AUTO, AUTO, 1, 0, 1, 2> cache_ax;
+typedef cache_view<cache_ax, 0> cache_x;
+typedef cache_view<cache_ax, 1> cache_a;
+typedef cache<int, false, true, 1, ROWS, 1, 1, WORDS, false, 0, 0, false, 3>
+	cache_y;
+
+template <typename T, typename U, typename V>
+	void matvec(T &x, U &a, V &y) {
+#pragma HLS inline
+		for (size_t row = 0; row < ROWS; row++) {
+			int sum = 0;
+			for (size_t col = 0; col < COLS; col += WORDS) {
+#pragma HLS pipeline
+				int a_line[WORDS];
+				a.get_line(((row * COLS) + col), 0, a_line, A_HINT);
+				for (size_t off = 0; off < WORDS; off++)
+					sum += (a_line[off] * x[col + off]);
+			}
+			y[row] = sum;
+		}
+	}
+
+void matvec_ref(const int *x, const int *a, int *y) {
+	for (size_t row = 0; row < ROWS; row++) {
+		int sum = 0;
+		for (size_t col = 0; col < COLS; col++)
+			sum += (a[(row * COLS) + col] * x[col]);
+		y[row] = sum;
+	}
+}
+
+extern "C" void matvec_top(int x[COLS], int a[N], int y[ROWS]) {
+#pragma HLS INTERFACE m_axi port=x bundle=gmem0 depth=COLS
+#pragma HLS INTERFACE m_axi port=a bundle=gmem0 depth=N
+#pragma HLS INTERFACE m_axi port=y bundle=gmem1 depth=ROWS
+#pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#pragma HLS dataflow disable_start_propagation
+	int *arrays[] = {x, a};
+	cache_ax ax_cache(arrays);
+	cache_x x_view(ax_cache);
+	cache_a a_view(ax_cache);
+	cache_y y_cache(y);
+
+	cache_wrapper(matvec<cache_x, cache_a, cache_y>,
+			x_view, a_view, y_cache);
+
+#ifndef __SYNTHESIS__
+	printf("x and a hit ratio = %d/%d\n", ax_cache.get_n_hits(0),
+			ax_cache.get_n_reqs(0));
+#endif /* __SYNTHESIS__ */
+}
+
+int main() {
+	static int x[COLS];
+	static int a[N];
+	int y[ROWS];
+	int y_ref[ROWS];
+
+	for (size_t i = 0; i < COLS; i++)
+		x[i] = (std::rand() % 256);
+	for (size_t i = 0; i < N; i++)
+		a[i] = (std::rand() % 256);
+
+	matvec_top(x, a, y);
+	matvec_ref(x, a, y_ref);
+
+	int ret = 0;
+	for (size_t row = 0; row < ROWS; row++) {
+		if (y[row] != y_ref[row])
+			ret = 1;
+	}
+
+	return ret;
+}
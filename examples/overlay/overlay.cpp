@@ -0,0 +1,91 @@
+#include <iostream>
+#include "cache.h"
+
+static const size_t N = 4096;
+static const size_t WORDS = 16;
+static const int THRESHOLD = 192;
+
+// the input is read by lines, and the outputs are written by lines: the
+// lines of the scaled copy are written whole, so that they are never loaded
+// from main memory, while only the words above the threshold are written
+// over the background
+typedef cache<int, true, false, 1, N, 1, 1, WORDS, false, 0, 0, false, 7>
+	cache_a;
+typedef cache<int, true, true, 1, N, 4, 2, WORDS, true, 0, 0, false, 2, AUTO,
+	AUTO, 1, 0, 1, 1, no_set_hash, false, false, false, no_way_partition,
+	ROUND_ROBIN, true> cache_bg;
+typedef cache<int, false, true, 1, N, 1, 1, WORDS, false, 0, 0, false, 3,
+	AUTO, AUTO, 1, 0, 1, 1, no_set_hash, false, false, false,
+	no_way_partition, ROUND_ROBIN, true> cache_scaled;
+
+template <typename T, typename U, typename V>
+	void overlay(T &a, U &bg, V &scaled) {
+#pragma HLS inline
+		for (size_t i = 0; i < N; i += WORDS) {
+#pragma HLS pipeline
+			int line[WORDS];
+			int scaled_line[WORDS];
+			ap_uint<WORDS> mask;
+			a.get_line(i, 0, line);
+			for (size_t off = 0; off < WORDS; off++) {
+				scaled_line[off] = (2 * line[off]);
+				mask[off] = (line[off] > THRESHOLD);
+			}
+			bg.set_line_masked(i, line, mask);
+			scaled.set_line(i, scaled_line);
+		}
+	}
+
+void overlay_ref(const int *a, int *bg, int *scaled) {
+	for (size_t i = 0; i < N; i++) {
+		if (a[i] > THRESHOLD)
+			bg[i] = a[i];
+		scaled[i] = (2 * a[i]);
+	}
+}
+
+extern "C" void overlay_top(int a[N], int bg[N], int scaled[N]) {
+#pragma HLS INTERFACE m_axi port=a bundle=gmem0 depth=N
+#pragma HLS INTERFACE m_axi port=bg bundle=gmem1 depth=N
+#pragma HLS INTERFACE m_axi port=scaled bundle=gmem2 depth=N
+#pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#pragma HLS dataflow disable_start_propagation
+	cache_a a_cache(a);
+	cache_bg bg_cache(bg);
+	cache_scaled scaled_cache(scaled);
+
+	cache_wrapper(overlay<cache_a, cache_bg, cache_scaled>,
+			a_cache, bg_cache, scaled_cache);
+
+#ifndef __SYNTHESIS__
+	printf("bg hit ratio = %d/%d\n", bg_cache.get_n_hits(0),
+			bg_cache.get_n_reqs(0));
+	printf("scaled hit ratio = %d/%d\n", scaled_cache.get_n_hits(0),
+			scaled_cache.get_n_reqs(0));
+#endif /* __SYNTHESIS__ */
+}
+
+int main() {
+	static int a[N];
+	static int bg[N];
+	static int bg_ref[N];
+	static int scaled[N];
+	static int scaled_ref[N];
+
+	for (size_t i = 0; i < N; i++) {
+		a[i] = (std::rand() % 256);
+		bg[i] = bg_ref[i] = (std::rand() % 256);
+	}
+
+	overlay_top(a, bg, scaled);
+	overlay_ref(a, bg_ref, scaled_ref);
+
+	int ret = 0;
+	for (size_t i = 0; i < N; i++) {
+		if ((bg[i] != bg_ref[i]) || (scaled[i] != scaled_ref[i]))
+			ret = 1;
+	}
+
+	return ret;
+}
@@ -0,0 +1,74 @@
+#include <iostream>
+#include "cache.h"
+
+static const size_t TABLE_SIZE = 384;
+static const size_t DATA_SIZE = 8192;
+static const size_t N = (TABLE_SIZE + DATA_SIZE);
+
+// the buffer holds a table followed by the data to be remapped through it:
+// port 0 looks up the table, while port 1 streams the data; the data can
+// only be inserted in the last way, so that they never evict the table,
+// which takes the other 3 ways
+#ifndef WAY_PARTITION_TYPE
+#define WAY_PARTITION_TYPE mask_way_partition<0x7, 0x8>
+#endif /* WAY_PARTITION_TYPE */
+
+typedef cache<int, true, false, 2, N, 8, 4, 16, false, 0, 0, false, 7, AUTO,
+	AUTO, 1, 0, 1, 1, no_set_hash, false, false, false,
+	WAY_PARTITION_TYPE> cache_buf;
+typedef cache<int, false, true, 1, DATA_SIZE, 1, 1, 16, false, 0, 0, false, 3>
+	cache_out;
+
+template <typename T, typename U>
+	void remap(T &buf, U &out) {
+#pragma HLS inline
+		for (size_t i = 0; i < DATA_SIZE; i++) {
+#pragma HLS pipeline
+			const int data = buf.get((TABLE_SIZE + i), 1);
+			out[i] = buf.get((static_cast<unsigned int>(data) % TABLE_SIZE), 0);
+		}
+	}
+
+void remap_ref(const int *buf, int *out) {
+	for (size_t i = 0; i < DATA_SIZE; i++)
+		out[i] = buf[static_cast<unsigned int>(buf[TABLE_SIZE + i]) % TABLE_SIZE];
+}
+
+extern "C" void remap_top(int buf[N], int out[DATA_SIZE]) {
+#pragma HLS INTERFACE m_axi port=buf bundle=gmem0 depth=N
+#pragma HLS INTERFACE m_axi port=out bundle=gmem1 depth=DATA_SIZE
+#pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#pragma HLS dataflow disable_start_propagation
+	cache_buf buf_cache(buf);
+	cache_out out_cache(out);
+
+	cache_wrapper(remap<cache_buf, cache_out>, buf_cache, out_cache);
+
+#ifndef __SYNTHESIS__
+	printf("table hit ratio = %d/%d\n", buf_cache.get_n_hits(0),
+			buf_cache.get_n_reqs(0));
+	printf("data hit ratio = %d/%d\n", buf_cache.get_n_hits(1),
+			buf_cache.get_n_reqs(1));
+#endif /* __SYNTHESIS__ */
+}
+
+int main() {
+	static int buf[N];
+	static int out[DATA_SIZE];
+	static int out_ref[DATA_SIZE];
+
+	for (size_t i = 0; i < N; i++)
+		buf[i] = std::rand();
+
+	remap_top(buf, out);
+	remap_ref(buf, out_ref);
+
+	int ret = 0;
+	for (size_t i = 0; i < DATA_SIZE; i++) {
+		if (out[i] != out_ref[i])
+			ret = 1;
+	}
+
+	return ret;
+}
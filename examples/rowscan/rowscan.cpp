@@ -0,0 +1,67 @@
+#include <iostream>
+#include "cache.h"
+
+static const size_t N_ROWS = 16;
+static const size_t ROW_SIZE = 1000;
+static const size_t N = (N_ROWS * ROW_SIZE);
+
+// the cache covers one row at a time of a larger buffer: tags are sized for
+// a single row, and the window is moved to the next row once it is scanned
+typedef cache<int, true, true, 1, ROW_SIZE, 4, 2, 16, true, 0, 0, false, 2,
+	AUTO, AUTO, 1, 0, 1, 1, no_set_hash, true> cache_t;
+
+// inclusive prefix sum of each row, in place
+template <typename T>
+	void rowscan(T &a) {
+#pragma HLS inline
+		for (size_t row = 0; row < N_ROWS; row++) {
+			a.set_window((row * ROW_SIZE), ROW_SIZE);
+			int sum = 0;
+			for (size_t i = 0; i < ROW_SIZE; i++) {
+#pragma HLS pipeline
+				sum += a[i];
+				a[i] = sum;
+			}
+		}
+	}
+
+void rowscan_ref(int *a) {
+	for (size_t row = 0; row < N_ROWS; row++) {
+		int sum = 0;
+		for (size_t i = 0; i < ROW_SIZE; i++) {
+			sum += a[(row * ROW_SIZE) + i];
+			a[(row * ROW_SIZE) + i] = sum;
+		}
+	}
+}
+
+extern "C" void rowscan_top(int a[N]) {
+#pragma HLS INTERFACE m_axi port=a bundle=gmem0 depth=N
+#pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#pragma HLS dataflow disable_start_propagation
+	cache_t a_cache(a);
+
+	cache_wrapper(rowscan<cache_t>, a_cache);
+}
+
+int main() {
+	static int a[N];
+	static int a_ref[N];
+
+	for (size_t i = 0; i < N; i++) {
+		a[i] = (std::rand() % 256);
+		a_ref[i] = a[i];
+	}
+
+	rowscan_top(a);
+	rowscan_ref(a_ref);
+
+	int ret = 0;
+	for (size_t i = 0; i < N; i++) {
+		if (a[i] != a_ref[i])
+			ret = 1;
+	}
+
+	return ret;
+}
@@ -0,0 +1,107 @@
+#include <iostream>
+#include "cache.h"
+
+static const size_t ROWS = 1024;
+static const size_t COLS = 1024;
+// non-zero elements of each row
+static const size_t K = 4;
+static const size_t NNZ = (ROWS * K);
+static const size_t X_ADDR_SIZE = utils::log2_ceil(COLS);
+
+// sparse matrix-vector product, with the matrix in ELLPACK format stored
+// by columns: the K non-zero elements of a row (and their column indices)
+// are ROWS words apart, and are read with a strided access, while the
+// elements of the vector they multiply are read with a gather
+typedef cache<int, true, false, 1, NNZ, 4, 4, 16, true, 0, 0, false, 7>
+	cache_val;
+typedef cache<int, true, false, 1, NNZ, 4, 4, 16, true, 0, 0, false, 7>
+	cache_col;
+typedef cache<int, true, false, 1, COLS, 8, 2, 16, true, 0, 0, false, 7>
+	cache_x;
+typedef cache<int, false, true, 1, ROWS, 1, 1, 16, false, 0, 0, false, 3>
+	cache_y;
+
+template <typename T, typename U, typename V, typename W>
+	void spmv(T &val, U &col, V &x, W &y) {
+#pragma HLS inline
+		for (size_t row = 0; row < ROWS; row++) {
+#pragma HLS pipeline
+			int vals[K];
+			int cols[K];
+			int xs[K];
+			ap_uint<X_ADDR_SIZE> x_addrs[K];
+			val.template get_strided<K>(row, ROWS, 0, vals);
+			col.template get_strided<K>(row, ROWS, 0, cols);
+			for (size_t k = 0; k < K; k++)
+				x_addrs[k] = cols[k];
+			x.template gather<K>(x_addrs, 0, xs);
+
+			int sum = 0;
+			for (size_t k = 0; k < K; k++)
+				sum += (vals[k] * xs[k]);
+			y[row] = sum;
+		}
+	}
+
+void spmv_ref(const int *val, const int *col, const int *x, int *y) {
+	for (size_t row = 0; row < ROWS; row++) {
+		int sum = 0;
+		for (size_t k = 0; k < K; k++)
+			sum += (val[(k * ROWS) + row] * x[col[(k * ROWS) + row]]);
+		y[row] = sum;
+	}
+}
+
+extern "C" void spmv_top(int val[NNZ], int col[NNZ], int x[COLS],
+		int y[ROWS]) {
+#pragma HLS INTERFACE m_axi port=val bundle=gmem0 depth=NNZ
+#pragma HLS INTERFACE m_axi port=col bundle=gmem1 depth=NNZ
+#pragma HLS INTERFACE m_axi port=x bundle=gmem2 depth=COLS
+#pragma HLS INTERFACE m_axi port=y bundle=gmem3 depth=ROWS
+#pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#pragma HLS dataflow disable_start_propagation
+	cache_val val_cache(val);
+	cache_col col_cache(col);
+	cache_x x_cache(x);
+	cache_y y_cache(y);
+
+	cache_wrapper(spmv<cache_val, cache_col, cache_x, cache_y>,
+			val_cache, col_cache, x_cache, y_cache);
+
+#ifndef __SYNTHESIS__
+	printf("val hit ratio = %d/%d\n", val_cache.get_n_hits(0),
+			val_cache.get_n_reqs(0));
+	printf("x hit ratio = %d/%d\n", x_cache.get_n_hits(0),
+			x_cache.get_n_reqs(0));
+#endif /* __SYNTHESIS__ */
+}
+
+int main() {
+	static int val[NNZ];
+	static int col[NNZ];
+	static int x[COLS];
+	int y[ROWS];
+	int y_ref[ROWS];
+
+	// the non-zero elements are close to the diagonal
+	for (size_t row = 0; row < ROWS; row++) {
+		for (size_t k = 0; k < K; k++) {
+			val[(k * ROWS) + row] = ((std::rand() % 256) - 128);
+			col[(k * ROWS) + row] = ((row + (std::rand() % 64)) % COLS);
+		}
+	}
+	for (size_t i = 0; i < COLS; i++)
+		x[i] = (std::rand() % 256);
+
+	spmv_top(val, col, x, y);
+	spmv_ref(val, col, x, y_ref);
+
+	int ret = 0;
+	for (size_t row = 0; row < ROWS; row++) {
+		if (y[row] != y_ref[row])
+			ret = 1;
+	}
+
+	return ret;
+}
@@ -0,0 +1,70 @@
+#include <iostream>
+#include "cache.h"
+
+static const size_t N = 4096;
+static const size_t PORTS = 2;
+
+// the 3 reads of each point do not specify a port: with LINE_INTERLEAVED
+// every line is always read from the same port, so that it is loaded in a
+// single L1 cache, while with ROUND_ROBIN both L1 caches load all the lines;
+// this only halves the L2 requests, since the 3 reads can fall on the same
+// port and then need an initiation interval of 3
+#ifndef PORT_POLICY_TYPE
+#define PORT_POLICY_TYPE LINE_INTERLEAVED
+#endif /* PORT_POLICY_TYPE */
+
+typedef cache<int, true, false, PORTS, N, 8, 2, 16, true, 2, 1, false, 7,
+	AUTO, AUTO, 1, 0, 1, 1, no_set_hash, false, false, false,
+	no_way_partition, PORT_POLICY_TYPE> cache_a;
+typedef cache<int, false, true, 1, N, 1, 1, 16, false, 0, 0, false, 3>
+	cache_b;
+
+template <typename T, typename U>
+	void stencil(T &a, U &b) {
+#pragma HLS inline
+		for (size_t i = 1; i < (N - 1); i++) {
+#pragma HLS pipeline
+			b[i] = (a[i - 1] + a[i] + a[i + 1]);
+		}
+	}
+
+extern "C" void stencil_top(int a[N], int b[N]) {
+#pragma HLS INTERFACE m_axi port=a bundle=gmem0 depth=N
+#pragma HLS INTERFACE m_axi port=b bundle=gmem1 depth=N
+#pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#pragma HLS dataflow disable_start_propagation
+	cache_a a_cache(a);
+	cache_b b_cache(b);
+
+	cache_wrapper(stencil<cache_a, cache_b>, a_cache, b_cache);
+
+#ifndef __SYNTHESIS__
+	printf("a hit ratio = \n");
+	for (size_t port = 0; port < PORTS; port++) {
+		printf("\tP=%lu: L1=%d/%d; L2=%d/%d\n", port,
+				a_cache.get_n_l1_hits(port), a_cache.get_n_l1_reqs(port),
+				a_cache.get_n_hits(port), a_cache.get_n_reqs(port));
+	}
+#endif /* __SYNTHESIS__ */
+}
+
+int main() {
+	static int a[N];
+	static int b[N];
+	static int b_ref[N];
+
+	for (size_t i = 0; i < N; i++)
+		a[i] = (std::rand() % 256);
+
+	stencil_top(a, b);
+	stencil(a, b_ref);
+
+	int ret = 0;
+	for (size_t i = 1; i < (N - 1); i++) {
+		if (b[i] != b_ref[i])
+			ret = 1;
+	}
+
+	return ret;
+}
@@ -0,0 +1,79 @@
+#include <iostream>
+#include <cmath>
+#include "cache.h"
+
+static const size_t N = 4096;
+static const size_t LUT_SIZE = 256;
+
+// the gamma correction table and the image share the cache: the table is
+// loaded with a single burst and pinned at the beginning, taking one way of
+// each set, so that the pixels streamed through the other way never evict it
+typedef cache<int, true, false, 1, N, 16, 2, 16, true, 0, 0, false, 7, AUTO,
+	AUTO, 1, 0, 1, 2, no_set_hash, false, true> cache_type;
+typedef cache<int, false, true, 1, N, 1, 1, 16, false, 0, 0, false, 3>
+	cache_out;
+typedef cache_view<cache_type, 0> lut_view_type;
+typedef cache_view<cache_type, 1> img_view_type;
+
+template <typename T, typename U, typename V>
+	void tonemap(T &lut, U &img, V &out) {
+#pragma HLS inline
+		lut.preload(0, LUT_SIZE, true);
+		for (size_t i = 0; i < N; i++) {
+#pragma HLS pipeline
+			const int pixel = img[i];
+			out[i] = lut[pixel];
+		}
+	}
+
+void tonemap_ref(const int *lut, const int *img, int *out) {
+	for (size_t i = 0; i < N; i++)
+		out[i] = lut[img[i]];
+}
+
+extern "C" void tonemap_top(int lut[LUT_SIZE], int img[N], int out[N]) {
+#pragma HLS INTERFACE m_axi port=lut bundle=gmem0 depth=LUT_SIZE
+#pragma HLS INTERFACE m_axi port=img bundle=gmem0 depth=N
+#pragma HLS INTERFACE m_axi port=out bundle=gmem1 depth=N
+#pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#pragma HLS dataflow disable_start_propagation
+	int * const arrays[] = {lut, img};
+	const size_t sizes[] = {LUT_SIZE, N};
+	cache_type lut_img_cache(arrays, sizes);
+	lut_view_type lut_view(lut_img_cache);
+	img_view_type img_view(lut_img_cache);
+	cache_out out_cache(out);
+
+	cache_wrapper(tonemap<lut_view_type, img_view_type, cache_out>,
+			lut_view, img_view, out_cache);
+
+#ifndef __SYNTHESIS__
+	printf("lut/img hit ratio = %d/%d\n", lut_img_cache.get_n_hits(0),
+			lut_img_cache.get_n_reqs(0));
+#endif /* __SYNTHESIS__ */
+}
+
+int main() {
+	static int lut[LUT_SIZE];
+	static int img[N];
+	static int out[N];
+	static int out_ref[N];
+
+	// gamma = 2.2
+	for (size_t i = 0; i < LUT_SIZE; i++)
+		lut[i] = static_cast<int>(255.0 * std::pow(i / 255.0, 1 / 2.2));
+	for (size_t i = 0; i < N; i++)
+		img[i] = (std::rand() % LUT_SIZE);
+
+	tonemap_top(lut, img, out);
+	tonemap_ref(lut, img, out_ref);
+
+	int ret = 0;
+	for (size_t i = 0; i < N; i++) {
+		if (out[i] != out_ref[i])
+			ret = 1;
+	}
+
+	return ret;
+}
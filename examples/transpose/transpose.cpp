@@ -0,0 +1,69 @@
+#include <iostream>
+#include "cache.h"
+
+static const size_t WIDTH = 64;
+static const size_t HEIGHT = 64;
+static const size_t N = (WIDTH * HEIGHT);
+static const size_t TILE_WIDTH = 4;
+
+// the matrix is read down its columns: with tiled_layout each line holds a
+// 4x4 tile, so that a column walk misses once every 4 rows, and the 16
+// tiles of a column of tiles serve the following 3 columns too, while with
+// linear_layout every row of the walk is a different line
+#ifndef LINE_LAYOUT_TYPE
+#define LINE_LAYOUT_TYPE tiled_layout<WIDTH, TILE_WIDTH>
+#endif /* LINE_LAYOUT_TYPE */
+
+typedef cache<int, true, false, 1, N, 1, 16, 16, true, 0, 0, false, 7, AUTO,
+	AUTO, 1, 0, 1, 1, no_set_hash, false, false, false, no_way_partition,
+	ROUND_ROBIN, false, false, set_update, LINE_LAYOUT_TYPE> cache_a;
+typedef cache<int, false, true, 1, N, 1, 1, 16, false, 0, 0, false, 3>
+	cache_b;
+
+template <typename T, typename U>
+	void transpose(T &a, U &b) {
+#pragma HLS inline
+		for (size_t x = 0; x < WIDTH; x++) {
+			for (size_t y = 0; y < HEIGHT; y++) {
+#pragma HLS pipeline
+				b[(x * HEIGHT) + y] = a[(y * WIDTH) + x];
+			}
+		}
+	}
+
+extern "C" void transpose_top(int a[N], int b[N]) {
+#pragma HLS INTERFACE m_axi port=a bundle=gmem0 depth=N
+#pragma HLS INTERFACE m_axi port=b bundle=gmem1 depth=N
+#pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#pragma HLS dataflow disable_start_propagation
+	cache_a a_cache(a);
+	cache_b b_cache(b);
+
+	cache_wrapper(transpose<cache_a, cache_b>, a_cache, b_cache);
+
+#ifndef __SYNTHESIS__
+	printf("a hit ratio = %d/%d\n", a_cache.get_n_hits(0),
+			a_cache.get_n_reqs(0));
+#endif /* __SYNTHESIS__ */
+}
+
+int main() {
+	static int a[N];
+	static int b[N];
+	static int b_ref[N];
+
+	for (size_t i = 0; i < N; i++)
+		a[i] = (std::rand() % 256);
+
+	transpose_top(a, b);
+	transpose(a, b_ref);
+
+	int ret = 0;
+	for (size_t i = 0; i < N; i++) {
+		if (b[i] != b_ref[i])
+			ret = 1;
+	}
+
+	return ret;
+}
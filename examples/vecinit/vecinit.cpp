@@ -2,8 +2,13 @@
 #include "cache.h"
 
 static const size_t N = 128;
+static const size_t AXI_WIDTH = 128;
+static const size_t N_WORDS_PER_BEAT = (AXI_WIDTH / (sizeof(int) * 8));
+static const size_t N_BEATS = (N / N_WORDS_PER_BEAT);
 
-typedef cache<int, false, true, 1, N, 1, 1, 8, false, 0, 0, false, 7> cache_t;
+typedef ap_uint<AXI_WIDTH> beat_type;
+typedef cache<int, false, true, 1, N, 1, 1, 8, false, 0, 0, false, 7, AUTO,
+	AUTO, 1, AXI_WIDTH> cache_t;
 
 template <typename T>
 	void vecinit(T &a) {
@@ -14,8 +19,8 @@ template <typename T>
 		}
 	}
 
-extern "C" void vecinit_top(int a[N]) {
-#pragma HLS INTERFACE m_axi port=a bundle=gmem0 depth=N
+extern "C" void vecinit_top(beat_type a[N_BEATS]) {
+#pragma HLS INTERFACE m_axi port=a bundle=gmem0 depth=N_BEATS
 #pragma HLS INTERFACE ap_ctrl_hs port=return
 
 #pragma HLS dataflow disable_start_propagation
@@ -25,14 +30,17 @@ extern "C" void vecinit_top(int a[N]) {
 }
 
 int main() {
-	int a[N];
+	beat_type a[N_BEATS];
 	int ret = 0;
 
 	vecinit_top(a);
 
 	for (int i = 0; i < N; i++) {
-		std::cout << a[i] << " ";
-		if (a[i] != i)
+		const int data = a[i / N_WORDS_PER_BEAT].range(
+				(((i % N_WORDS_PER_BEAT) + 1) * 32) - 1,
+				((i % N_WORDS_PER_BEAT) * 32)).to_uint64();
+		std::cout << data << " ";
+		if (data != i)
 			ret = 1;
 	}
 
@@ -17,7 +17,6 @@ set_part ${parts}
 create_clock -period ${t_clk}
 config_interface -m_axi_latency ${m_axi_latency}
 config_interface -m_axi_max_bitwidth ${m_axi_bitwidth}
-config_interface -m_axi_max_widen_bitwidth ${m_axi_bitwidth}
 
 csim_design
 csynth_design
@@ -0,0 +1,62 @@
+#include <iostream>
+#include "cache.h"
+
+static const size_t N = 4096;
+static const size_t MEM_PORTS = 2;
+// coprime with N, so that every element is visited once
+static const size_t STEP = 37;
+
+// the vector is scaled in place, in an order which makes evicted lines
+// often belong to another memory port than the loaded ones, so that their
+// write-backs are sent separately; dirty lines are then flushed with a
+// burst per memory port
+typedef cache<int, true, true, 1, N, 4, 2, 16, true, 0, 0, false, 2, AUTO,
+	AUTO, 1, 0, MEM_PORTS> cache_a;
+
+template <typename T>
+	void vecscale(T &a) {
+#pragma HLS inline
+		for (size_t i = 0; i < N; i++) {
+#pragma HLS pipeline
+			const size_t j = ((i * STEP) % N);
+			const int data = a[j];
+			a[j] = (data * 3);
+		}
+	}
+
+extern "C" void vecscale_top(int a0[N], int a1[N]) {
+#pragma HLS INTERFACE m_axi port=a0 bundle=gmem0 depth=N
+#pragma HLS INTERFACE m_axi port=a1 bundle=gmem1 depth=N
+#pragma HLS INTERFACE ap_ctrl_hs port=return
+
+#pragma HLS dataflow disable_start_propagation
+	// one pointer for each memory port, aliasing the same vector
+	int * const a[MEM_PORTS] = {a0, a1};
+	cache_a a_cache(a);
+
+	cache_wrapper(vecscale<cache_a>, a_cache);
+
+#ifndef __SYNTHESIS__
+	printf("a hit ratio = %d/%d\n", a_cache.get_n_hits(0),
+			a_cache.get_n_reqs(0));
+#endif /* __SYNTHESIS__ */
+}
+
+int main() {
+	static int a[N];
+	static int a_ref[N];
+
+	for (size_t i = 0; i < N; i++)
+		a[i] = a_ref[i] = (std::rand() % 256);
+
+	vecscale_top(a, a);
+	vecscale(a_ref);
+
+	int ret = 0;
+	for (size_t i = 0; i < N; i++) {
+		if (a[i] != a_ref[i])
+			ret = 1;
+	}
+
+	return ret;
+}
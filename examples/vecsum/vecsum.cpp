@@ -32,9 +32,8 @@ extern "C" void vecsum_top(int a[N], int &sum) {
 #pragma HLS INTERFACE ap_ctrl_hs port=return
 
 #pragma HLS dataflow disable_start_propagation
-	cache_a a_cache;
+	cache_a a_cache(a);
 
-	a_cache.run(a);
 	cache_wrapper(vecsum<cache_a>, a_cache, sum);
 }
 
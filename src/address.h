@@ -9,14 +9,241 @@
 #pragma GCC diagnostic error "-Wextra"
 #pragma GCC diagnostic ignored "-Wunused-label"
 
+/**
+ * \brief	Set-index hashing policies.
+ *
+ *		A policy maps the line address (i.e., the concatenation of
+ *		tag and set index) onto the line address from which the
+ *		actual tag and set index are extracted. The mapping is
+ *		invertible, so that the main memory address can be rebuilt
+ *		from tag and set index (e.g., for write-backs).
+ */
+template <size_t TAG_SIZE, size_t SET_SIZE>
+using hash_line_type = ap_uint<((TAG_SIZE + SET_SIZE) > 0) ?
+	(TAG_SIZE + SET_SIZE) : 1>;
+
+/**
+ * \brief	Set index made of the lowest bits of the line address.
+ */
+struct no_set_hash {
+	template <size_t TAG_SIZE, size_t SET_SIZE>
+	static hash_line_type<TAG_SIZE, SET_SIZE> map(
+			const hash_line_type<TAG_SIZE, SET_SIZE> line) {
+#pragma HLS inline
+		return line;
+	}
+
+	template <size_t TAG_SIZE, size_t SET_SIZE>
+	static hash_line_type<TAG_SIZE, SET_SIZE> unmap(
+			const hash_line_type<TAG_SIZE, SET_SIZE> line) {
+#pragma HLS inline
+		return line;
+	}
+};
+
+/**
+ * \brief	Set index XORed with the tag folded on the set index width.
+ *
+ * \note	The tag is unchanged, so the mapping is its own inverse.
+ */
+struct xor_set_hash {
+	template <size_t TAG_SIZE, size_t SET_SIZE>
+	static hash_line_type<TAG_SIZE, SET_SIZE> map(
+			const hash_line_type<TAG_SIZE, SET_SIZE> line) {
+#pragma HLS inline
+		hash_line_type<TAG_SIZE, SET_SIZE> hashed = line;
+		if (SET_SIZE > 0) {
+			for (size_t bit = 0; bit < TAG_SIZE; bit++) {
+#pragma HLS unroll
+				const auto set_bit = (bit % ((SET_SIZE > 0) ? SET_SIZE : 1));
+				hashed[set_bit] = (hashed[set_bit] ^ line[SET_SIZE + bit]);
+			}
+		}
+
+		return hashed;
+	}
+
+	template <size_t TAG_SIZE, size_t SET_SIZE>
+	static hash_line_type<TAG_SIZE, SET_SIZE> unmap(
+			const hash_line_type<TAG_SIZE, SET_SIZE> line) {
+#pragma HLS inline
+		return map<TAG_SIZE, SET_SIZE>(line);
+	}
+};
+
+/**
+ * \brief	Set index made of arbitrary bits of the line address.
+ *
+ *		Bit i of the set index is bit \p SET_BITS[i] of the line
+ *		address, while the tag is made of the remaining bits (in the
+ *		same order).
+ *
+ * \note	\p SET_BITS must be distinct and lower than the line address
+ *		width.
+ */
+template <size_t... SET_BITS>
+struct select_set_hash {
+	static constexpr size_t BITS[sizeof...(SET_BITS) + 1] = {SET_BITS..., 0};
+
+	static constexpr bool is_set_bit(const size_t bit, const size_t i = 0) {
+		return ((i < sizeof...(SET_BITS)) &&
+				((BITS[i] == bit) || is_set_bit(bit, (i + 1))));
+	}
+
+	template <size_t TAG_SIZE, size_t SET_SIZE>
+	static hash_line_type<TAG_SIZE, SET_SIZE> map(
+			const hash_line_type<TAG_SIZE, SET_SIZE> line) {
+#pragma HLS inline
+		static_assert((sizeof...(SET_BITS) == SET_SIZE),
+				"the number of SET_BITS must be equal to the set index size");
+
+		hash_line_type<TAG_SIZE, SET_SIZE> hashed = 0;
+		for (size_t set_bit = 0; set_bit < SET_SIZE; set_bit++) {
+#pragma HLS unroll
+			hashed[set_bit] = line[BITS[set_bit]];
+		}
+
+		size_t tag_bit = SET_SIZE;
+		for (size_t bit = 0; bit < (TAG_SIZE + SET_SIZE); bit++) {
+#pragma HLS unroll
+			if (!is_set_bit(bit))
+				hashed[tag_bit++] = line[bit];
+		}
+
+		return hashed;
+	}
+
+	template <size_t TAG_SIZE, size_t SET_SIZE>
+	static hash_line_type<TAG_SIZE, SET_SIZE> unmap(
+			const hash_line_type<TAG_SIZE, SET_SIZE> hashed) {
+#pragma HLS inline
+		hash_line_type<TAG_SIZE, SET_SIZE> line = 0;
+		for (size_t set_bit = 0; set_bit < SET_SIZE; set_bit++) {
+#pragma HLS unroll
+			line[BITS[set_bit]] = hashed[set_bit];
+		}
+
+		size_t tag_bit = SET_SIZE;
+		for (size_t bit = 0; bit < (TAG_SIZE + SET_SIZE); bit++) {
+#pragma HLS unroll
+			if (!is_set_bit(bit))
+				line[bit] = hashed[tag_bit++];
+		}
+
+		return line;
+	}
+};
+
+template <size_t... SET_BITS>
+constexpr size_t select_set_hash<SET_BITS...>::BITS[];
+
+/**
+ * \brief	Line layout policies.
+ *
+ *		A policy maps the address of a word in main memory onto the
+ *		address from which tag, set index and offset are extracted,
+ *		so that it defines which words share a line. The mapping is
+ *		a permutation of the address bits, so that the main memory
+ *		address of each word of a line can be rebuilt (e.g., for
+ *		fills and write-backs).
+ */
+struct linear_layout {
+	static const bool TILED = false;
+	// rows of a single word, one word apart
+	static const size_t ROW_WIDTH = 1;
+	static const size_t ROW_PITCH = 1;
+
+	template <size_t ADDR_SIZE, size_t N_WORDS_PER_LINE>
+	static ap_uint<ADDR_SIZE> map(const ap_uint<ADDR_SIZE> addr) {
+#pragma HLS inline
+		return addr;
+	}
+
+	template <size_t ADDR_SIZE, size_t N_WORDS_PER_LINE>
+	static ap_uint<ADDR_SIZE> unmap(const ap_uint<ADDR_SIZE> addr) {
+#pragma HLS inline
+		return addr;
+	}
+};
+
+/**
+ * \brief	Lines made of 2-D tiles of a row-major matrix.
+ *
+ *		Each line holds (N_WORDS_PER_LINE / \p WIDTH) rows of \p WIDTH
+ *		consecutive words, the rows being \p PITCH words apart. Within
+ *		a line, words are stored row after row.
+ *
+ * \note	\p PITCH and \p WIDTH must be powers of 2, with \p WIDTH not
+ *		greater than \p PITCH nor than the line size.
+ */
+template <size_t PITCH, size_t WIDTH>
+struct tiled_layout {
+	static const bool TILED = true;
+	static const size_t ROW_WIDTH = WIDTH;
+	static const size_t ROW_PITCH = PITCH;
+
+	static constexpr size_t log2(const size_t n) {
+		return ((n <= 1) ? 0 : (1 + log2(n / 2)));
+	}
+
+	static const size_t COL_SIZE = log2(WIDTH);
+	static const size_t PITCH_SIZE = log2(PITCH);
+
+	static_assert(((WIDTH > 0) && ((static_cast<size_t>(1) << COL_SIZE) == WIDTH)),
+			"WIDTH must be a power of 2 greater than 0");
+	static_assert(((PITCH >= WIDTH) &&
+				((static_cast<size_t>(1) << PITCH_SIZE) == PITCH)),
+			"PITCH must be a power of 2 not lower than WIDTH");
+
+	template <size_t ADDR_SIZE, size_t N_WORDS_PER_LINE>
+	static ap_uint<ADDR_SIZE> map(const ap_uint<ADDR_SIZE> addr) {
+#pragma HLS inline
+		static_assert((WIDTH <= N_WORDS_PER_LINE),
+				"WIDTH must not be greater than N_WORDS_PER_LINE");
+		static const size_t ROW_SIZE = log2(N_WORDS_PER_LINE / WIDTH);
+		static_assert(((PITCH_SIZE + ROW_SIZE) <= ADDR_SIZE),
+				"a tile exceeds the address space");
+
+		// [y_hi | y_lo | x_hi | x_lo] -> [y_hi | x_hi | y_lo | x_lo]
+		const ap_uint<ADDR_SIZE> x_lo = (addr & (WIDTH - 1));
+		const ap_uint<ADDR_SIZE> x_hi = ((addr >> COL_SIZE) &
+				((PITCH / WIDTH) - 1));
+		const ap_uint<ADDR_SIZE> y_lo = ((addr >> PITCH_SIZE) &
+				((N_WORDS_PER_LINE / WIDTH) - 1));
+		const ap_uint<ADDR_SIZE> y_hi = (addr >> (PITCH_SIZE + ROW_SIZE));
+
+		return ((y_hi << (PITCH_SIZE + ROW_SIZE)) |
+				(x_hi << (COL_SIZE + ROW_SIZE)) |
+				(y_lo << COL_SIZE) | x_lo);
+	}
+
+	template <size_t ADDR_SIZE, size_t N_WORDS_PER_LINE>
+	static ap_uint<ADDR_SIZE> unmap(const ap_uint<ADDR_SIZE> addr) {
+#pragma HLS inline
+		static const size_t ROW_SIZE = log2(N_WORDS_PER_LINE / WIDTH);
+
+		const ap_uint<ADDR_SIZE> x_lo = (addr & (WIDTH - 1));
+		const ap_uint<ADDR_SIZE> y_lo = ((addr >> COL_SIZE) &
+				((N_WORDS_PER_LINE / WIDTH) - 1));
+		const ap_uint<ADDR_SIZE> x_hi = ((addr >> (COL_SIZE + ROW_SIZE)) &
+				((PITCH / WIDTH) - 1));
+		const ap_uint<ADDR_SIZE> y_hi = (addr >> (PITCH_SIZE + ROW_SIZE));
+
+		return ((y_hi << (PITCH_SIZE + ROW_SIZE)) |
+				(y_lo << PITCH_SIZE) | (x_hi << COL_SIZE) | x_lo);
+	}
+};
+
 template <size_t ADDR_SIZE, size_t TAG_SIZE, size_t SET_SIZE, size_t WAY_SIZE,
-	 bool SWAP_TAG_SET>
+	 bool SWAP_TAG_SET, typename SET_HASH = no_set_hash>
 class address {
 	private:
 		static const size_t OFF_SIZE = (ADDR_SIZE - (TAG_SIZE + SET_SIZE));
 		static const size_t CACHE_ADDR_SIZE = (SET_SIZE + WAY_SIZE + OFF_SIZE);
 		static const size_t LINE_ADDR_SIZE = (SET_SIZE + WAY_SIZE);
 
+		typedef hash_line_type<TAG_SIZE, SET_SIZE> hashed_line_type;
+
 	public:
 #ifdef __SYNTHESIS__
 		typedef ap_uint<ADDR_SIZE> addr_main_type;
@@ -27,13 +254,13 @@ class address {
 		typedef ap_uint<(CACHE_ADDR_SIZE > 0) ? CACHE_ADDR_SIZE : 1> addr_cache_type;
 		typedef ap_uint<(LINE_ADDR_SIZE > 0) ? LINE_ADDR_SIZE : 1> addr_line_type;
 #else
-		typedef unsigned long addr_main_type;
-		typedef unsigned long tag_type;
-		typedef unsigned long set_type;
-		typedef unsigned long way_type;
-		typedef unsigned long off_type;
-		typedef unsigned long addr_cache_type;
-		typedef unsigned long addr_line_type;
+		typedef unsigned long long addr_main_type;
+		typedef unsigned long long tag_type;
+		typedef unsigned long long set_type;
+		typedef unsigned long long way_type;
+		typedef unsigned long long off_type;
+		typedef unsigned long long addr_cache_type;
+		typedef unsigned long long addr_line_type;
 #endif /* __SYNTHESIS__ */
 
 		const addr_main_type m_addr_main;
@@ -44,25 +271,24 @@ class address {
 		addr_line_type m_addr_line;
 		way_type m_way;
 
-		address(const unsigned int addr_main):
+		address(const addr_main_type addr_main):
 			m_addr_main(addr_main),
 #ifdef __SYNTHESIS__
-			m_tag((TAG_SIZE > 0) ? (addr_main >> (OFF_SIZE + SET_SIZE)) : 0),
-			m_set((SET_SIZE > 0) ? (addr_main >> OFF_SIZE) : 0),
-			m_off((OFF_SIZE > 0) ? addr_main : 0)
+			m_tag((TAG_SIZE > 0) ? tag_type(hash(addr_main) >> SET_SIZE) : tag_type(0)),
+			m_set((SET_SIZE > 0) ? set_type(hash(addr_main)) : set_type(0)),
+			m_off((OFF_SIZE > 0) ? off_type(addr_main) : off_type(0))
 #else
-			m_tag((TAG_SIZE > 0) ? (addr_main >> (OFF_SIZE + SET_SIZE)) : 0),
-			m_set(((SET_SIZE > 0) ? (addr_main >> OFF_SIZE) : 0) & (~(-1U << SET_SIZE))),
-			m_off(((OFF_SIZE > 0) ? addr_main : 0) & (~(-1U << OFF_SIZE)))
+			m_tag((TAG_SIZE > 0) ? tag_type(hash(addr_main) >> SET_SIZE) : tag_type(0)),
+			m_set(((SET_SIZE > 0) ? set_type(hash(addr_main)) : 0) & (~(-1ULL << SET_SIZE))),
+			m_off(((OFF_SIZE > 0) ? addr_main : 0) & (~(-1ULL << OFF_SIZE)))
 #endif /* __SYNTHESIS__ */
 			{
 #pragma HLS inline
 			}
 
-		address(const unsigned int tag, const unsigned int set,
-				const unsigned int off, const unsigned int way):
-				m_addr_main((static_cast<addr_main_type>(tag) << (SET_SIZE + OFF_SIZE)) |
-						(static_cast<addr_main_type>(set) << OFF_SIZE) | off),
+		address(const tag_type tag, const set_type set,
+				const off_type off, const unsigned int way):
+				m_addr_main((static_cast<addr_main_type>(unhash(tag, set)) << OFF_SIZE) | off),
 				m_tag(tag), m_set(set), m_off(off) {
 #pragma HLS inline
 			set_way(way);
@@ -75,15 +301,52 @@ class address {
 			m_addr_cache = ((static_cast<addr_cache_type>(m_set) << (WAY_SIZE + OFF_SIZE)) |
 					(static_cast<addr_cache_type>(m_way) << OFF_SIZE) | m_off);
 		}
+
+	private:
+		/**
+		 * \brief		Map the line address of \p addr_main
+		 * 			with \p SET_HASH.
+		 *
+		 * \param[in] addr_main	The address in main memory.
+		 *
+		 * \return		The concatenation of tag and set index.
+		 */
+		static hashed_line_type hash(const addr_main_type addr_main) {
+#pragma HLS inline
+			const hashed_line_type line = (addr_main >> OFF_SIZE);
+
+			return SET_HASH::template map<TAG_SIZE, SET_SIZE>(line);
+		}
+
+		/**
+		 * \brief		Rebuild the line address from \p tag
+		 * 			and \p set.
+		 *
+		 * \param[in] tag	The tag.
+		 * \param[in] set	The set index.
+		 *
+		 * \return		The line address.
+		 */
+		static hashed_line_type unhash(const tag_type tag,
+				const set_type set) {
+#pragma HLS inline
+			const hashed_line_type hashed = ((hashed_line_type(tag) << SET_SIZE) |
+					hashed_line_type(set));
+
+			return SET_HASH::template unmap<TAG_SIZE, SET_SIZE>(hashed);
+		}
 };
 
-template <size_t ADDR_SIZE, size_t TAG_SIZE, size_t SET_SIZE, size_t WAY_SIZE>
-class address<ADDR_SIZE, TAG_SIZE, SET_SIZE, WAY_SIZE, true> {
+template <size_t ADDR_SIZE, size_t TAG_SIZE, size_t SET_SIZE, size_t WAY_SIZE,
+	 typename SET_HASH>
+class address<ADDR_SIZE, TAG_SIZE, SET_SIZE, WAY_SIZE, true, SET_HASH> {
 	private:
 		static const size_t OFF_SIZE = (ADDR_SIZE - (TAG_SIZE + SET_SIZE));
 		static const size_t CACHE_ADDR_SIZE = (SET_SIZE + WAY_SIZE + OFF_SIZE);
 		static const size_t LINE_ADDR_SIZE = (SET_SIZE + WAY_SIZE);
 
+		typedef hash_line_type<TAG_SIZE, SET_SIZE> hashed_line_type;
+
 	public:
 #ifdef __SYNTHESIS__
 		typedef ap_uint<ADDR_SIZE> addr_main_type;
@@ -94,13 +357,13 @@ class address<ADDR_SIZE, TAG_SIZE, SET_SIZE, WAY_SIZE, true> {
 		typedef ap_uint<(CACHE_ADDR_SIZE > 0) ? CACHE_ADDR_SIZE : 1> addr_cache_type;
 		typedef ap_uint<(LINE_ADDR_SIZE > 0) ? LINE_ADDR_SIZE : 1> addr_line_type;
 #else
-		typedef unsigned long addr_main_type;
-		typedef unsigned long tag_type;
-		typedef unsigned long set_type;
-		typedef unsigned long way_type;
-		typedef unsigned long off_type;
-		typedef unsigned long addr_cache_type;
-		typedef unsigned long addr_line_type;
+		typedef unsigned long long addr_main_type;
+		typedef unsigned long long tag_type;
+		typedef unsigned long long set_type;
+		typedef unsigned long long way_type;
+		typedef unsigned long long off_type;
+		typedef unsigned long long addr_cache_type;
+		typedef unsigned long long addr_line_type;
 #endif /* __SYNTHESIS__ */
 
 		const addr_main_type m_addr_main;
@@ -111,25 +374,24 @@ class address<ADDR_SIZE, TAG_SIZE, SET_SIZE, WAY_SIZE, true> {
 		addr_line_type m_addr_line;
 		way_type m_way;
 
-		address(const unsigned int addr_main):
+		address(const addr_main_type addr_main):
 			m_addr_main(addr_main),
 #ifdef __SYNTHESIS__
-			m_set((SET_SIZE > 0) ? (addr_main >> (OFF_SIZE + TAG_SIZE)) : 0),
-			m_tag((TAG_SIZE > 0) ? (addr_main >> OFF_SIZE) : 0),
-			m_off((OFF_SIZE > 0) ? addr_main : 0)
+			m_set((SET_SIZE > 0) ? set_type(hash(addr_main)) : set_type(0)),
+			m_tag((TAG_SIZE > 0) ? tag_type(hash(addr_main) >> SET_SIZE) : tag_type(0)),
+			m_off((OFF_SIZE > 0) ? off_type(addr_main) : off_type(0))
 #else
-			m_set((SET_SIZE > 0) ? (addr_main >> (OFF_SIZE + TAG_SIZE)) : 0),
-			m_tag(((TAG_SIZE > 0) ? (addr_main >> OFF_SIZE) : 0) & (~(-1U << TAG_SIZE))),
-			m_off(((OFF_SIZE > 0) ? addr_main : 0) & (~(-1U << OFF_SIZE)))
+			m_set(((SET_SIZE > 0) ? set_type(hash(addr_main)) : 0) & (~(-1ULL << SET_SIZE))),
+			m_tag((TAG_SIZE > 0) ? tag_type(hash(addr_main) >> SET_SIZE) : tag_type(0)),
+			m_off(((OFF_SIZE > 0) ? addr_main : 0) & (~(-1ULL << OFF_SIZE)))
 #endif /* __SYNTHESIS__ */
 			{
 #pragma HLS inline
 			}
 
-		address(const unsigned int tag, const unsigned int set,
-				const unsigned int off, const unsigned int way):
-				m_addr_main((static_cast<addr_main_type>(set) << (TAG_SIZE + OFF_SIZE)) |
-						(static_cast<addr_main_type>(tag) << OFF_SIZE) | off),
+		address(const tag_type tag, const set_type set,
+				const off_type off, const unsigned int way):
+				m_addr_main((static_cast<addr_main_type>(unhash(tag, set)) << OFF_SIZE) | off),
 				m_set(set), m_tag(tag), m_off(off) {
 #pragma HLS inline
 			set_way(way);
@@ -142,6 +404,45 @@ class address<ADDR_SIZE, TAG_SIZE, SET_SIZE, WAY_SIZE, true> {
 			m_addr_cache = ((static_cast<addr_cache_type>(m_set) << (WAY_SIZE + OFF_SIZE)) |
 					(static_cast<addr_cache_type>(m_way) << OFF_SIZE) | m_off);
 		}
+
+	private:
+		/**
+		 * \brief		Map the line address of \p addr_main
+		 * 			(with tag and set index swapped back)
+		 * 			with \p SET_HASH.
+		 *
+		 * \param[in] addr_main	The address in main memory.
+		 *
+		 * \return		The concatenation of tag and set index.
+		 */
+		static hashed_line_type hash(const addr_main_type addr_main) {
+#pragma HLS inline
+			const hashed_line_type swapped = (addr_main >> OFF_SIZE);
+			const hashed_line_type line = ((swapped << SET_SIZE) |
+					(swapped >> TAG_SIZE));
+
+			return SET_HASH::template map<TAG_SIZE, SET_SIZE>(line);
+		}
+
+		/**
+		 * \brief		Rebuild the line address (with set index
+		 * 			and tag swapped) from \p tag and \p set.
+		 *
+		 * \param[in] tag	The tag.
+		 * \param[in] set	The set index.
+		 *
+		 * \return		The line address.
+		 */
+		static hashed_line_type unhash(const tag_type tag,
+				const set_type set) {
+#pragma HLS inline
+			const hashed_line_type hashed = ((hashed_line_type(tag) << SET_SIZE) |
+					hashed_line_type(set));
+			const hashed_line_type line =
+				SET_HASH::template unmap<TAG_SIZE, SET_SIZE>(hashed);
+
+			return ((line << TAG_SIZE) | (line >> SET_SIZE));
+		}
 };
 
 #pragma GCC diagnostic pop
@@ -15,6 +15,22 @@
  *		Advanced features:
  *			- Multi-levels: L1 cache (direct-mapped, write-through).
  *			- Multi-ports (read-only).
+ *			- Sectored lines: lines are filled one sector
+ *			  at a time.
+ *			- Packed main memory: lines are transferred on
+ *			  full-width AXI beats.
+ *			- Multiple memory ports: lines are interleaved
+ *			  across multiple AXI ports.
+ *			- Multiple arrays: a single cache (and memory
+ *			  interface) is shared by several arrays.
+ *			- Set-index hashing: pluggable mapping of lines
+ *			  to L2 sets.
+ *			- Windowed: the cache covers a window of a larger
+ *			  buffer, which can be moved at run time.
+ *			- Decoupled access: reads are issued by a separate
+ *			  address-generator process (read-only caches).
+ *			- Tiled lines: a line holds a 2-D tile of a
+ *			  row-major matrix.
  */
 
 #include <cstddef>
@@ -25,6 +41,7 @@
 #include "replacer.h"
 #include "l1_cache.h"
 #include "raw_cache.h"
+#include "update.h"
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wattributes"
 #include <etc/autopilot_ssdm_op.h>
@@ -37,6 +54,9 @@
 #include "sliced_stream.h"
 #else
 #include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <queue>
 #include <cassert>
 #endif /* __SYNTHESIS__ */
 
@@ -48,29 +68,111 @@
 
 using namespace types;
 
+#ifndef __SYNTHESIS__
+/**
+ * \brief	Return whether the calling thread runs one of the processes
+ *		started by the decoupled \ref cache_wrapper, in which split
+ *		transactions block as the FIFOs would do.
+ *
+ * \return	A reference to the flag of the calling thread.
+ */
+inline bool &is_decoupled_thread() {
+	static thread_local bool decoupled = false;
+	return decoupled;
+}
+#endif /* __SYNTHESIS__ */
+
 template <typename T, bool RD_ENABLED, bool WR_ENABLED, size_t PORTS,
 	 size_t MAIN_SIZE, size_t N_SETS, size_t N_WAYS, size_t N_WORDS_PER_LINE,
 	 bool LRU, size_t N_L1_SETS, size_t N_L1_WAYS, bool SWAP_TAG_SET,
 	 size_t LATENCY, storage_impl_type L2_STORAGE_IMPL = AUTO,
-	 storage_impl_type L1_STORAGE_IMPL = AUTO>
+	 storage_impl_type L1_STORAGE_IMPL = AUTO, size_t N_SECTORS = 1,
+	 size_t AXI_WIDTH = 0, size_t MEM_PORTS = 1, size_t N_ARRAYS = 1,
+	 typename SET_HASH = no_set_hash, bool WINDOWED = false,
+	 bool PRELOAD = false, bool PREFETCH = false,
+	 typename WAY_PARTITION = no_way_partition,
+	 port_policy_type PORT_POLICY = ROUND_ROBIN, bool LINE_WRITES = false,
+	 bool ATOMIC = false, typename CUSTOM_UPDATE = set_update,
+	 typename LINE_LAYOUT = linear_layout>
 class cache {
+	template <typename, size_t> friend class cache_view;
+	template <typename, size_t> friend class cache_2d;
+
 	private:
 		static const bool L1_CACHE = ((N_L1_SETS * N_L1_WAYS) > 0);
 		static const bool RAW_CACHE = WR_ENABLED;
-		static const size_t ADDR_SIZE = utils::log2_ceil(MAIN_SIZE);
+		static const size_t ARRAY_ADDR_SIZE = utils::log2_ceil(MAIN_SIZE);
+		static const size_t ARRAY_ID_SIZE = utils::log2_ceil(N_ARRAYS);
+		// the array identifier is prepended to the address
+		static const size_t ADDR_SIZE = (ARRAY_ID_SIZE + ARRAY_ADDR_SIZE);
+		static const size_t ADDR_SPACE_SIZE = ((N_ARRAYS == 1) ? MAIN_SIZE :
+				(static_cast<size_t>(1) << ADDR_SIZE));
 		static const size_t SET_SIZE = utils::log2_ceil(N_SETS);
 		static const size_t OFF_SIZE = utils::log2_ceil(N_WORDS_PER_LINE);
 		static const size_t TAG_SIZE = (ADDR_SIZE - (SET_SIZE + OFF_SIZE));
 		static const size_t WAY_SIZE = utils::log2_ceil(N_WAYS);
 		static const size_t WORD_SIZE = (sizeof(T) * 8);
+		static const size_t N_WORDS_PER_SECTOR =
+			(N_WORDS_PER_LINE / ((N_SECTORS > 0) ? N_SECTORS : 1));
+		static const size_t SECTOR_OFF_SIZE =
+			utils::log2_ceil(N_WORDS_PER_SECTOR);
+		static const size_t N_WORDS_PER_BEAT =
+			((AXI_WIDTH > 0) ? (AXI_WIDTH / WORD_SIZE) : 1);
+		static const size_t BEAT_OFF_SIZE = utils::log2_ceil(N_WORDS_PER_BEAT);
+		static const size_t N_BEATS_PER_SECTOR =
+			utils::div_ceil(N_WORDS_PER_SECTOR, N_WORDS_PER_BEAT);
+		static const size_t N_BEATS_PER_LINE =
+			utils::div_ceil(N_WORDS_PER_LINE, N_WORDS_PER_BEAT);
+		static const size_t MEM_PORT_SIZE = utils::log2_ceil(MEM_PORTS);
+		// the last line of main memory is partial if MAIN_SIZE (or
+		// the window length, or the size of each array) is not a
+		// multiple of the line size
+		static const bool PARTIAL_LINE = (WINDOWED || (N_ARRAYS > 1) ||
+				((MAIN_SIZE % N_WORDS_PER_LINE) != 0));
+		// the whole main memory fits in the cache: each line has a
+		// fixed place (the way is given by the tag), so that it is
+		// loaded once at the beginning and never evicted
+		static const bool RESIDENT = (TAG_SIZE <= WAY_SIZE);
+		static const size_t N_RESIDENT_LINES =
+			utils::div_ceil(ADDR_SPACE_SIZE, N_WORDS_PER_LINE);
+		// tags, valid bits and sector masks are only kept when the
+		// cache is not resident
+		static const size_t N_TAGGED_LINES =
+			(RESIDENT ? 1 : (N_SETS * N_WAYS));
+		// a resident cache serves requests without tag lookup,
+		// replacement or refill, so responses come sooner: one cycle
+		// to cross the request FIFO, plus the read of the cache
+		// memory (URAM needs an extra output register to meet timing,
+		// while BRAM and LUTRAM are read in a single cycle)
+		static const size_t L2_READ_LATENCY =
+			((L2_STORAGE_IMPL == URAM) ? 2 : 1);
+		static const size_t RESIDENT_LATENCY = (1 + L2_READ_LATENCY);
+		static const size_t RESP_LATENCY =
+			((RESIDENT && (LATENCY > RESIDENT_LATENCY)) ?
+			 RESIDENT_LATENCY : LATENCY);
+		// prefetch requests exceeding the queue are dropped
+		static const size_t PREFETCH_DEPTH = 4;
+		// split-transaction reads outstanding on each port
+		static const size_t MAX_OUTSTANDING = (LATENCY * PORTS);
+		// number of ports, for views
+		static const size_t N_PORTS = PORTS;
+		// size of the array, for 2-D views, which require a single
+		// array fixed in main memory
+		static const size_t ARRAY_SIZE = MAIN_SIZE;
+		static const bool FIXED_ARRAY = ((N_ARRAYS == 1) && !WINDOWED);
+		// lines are 2-D tiles: the words of a line are in rows of
+		// TILE_WIDTH consecutive words, TILE_PITCH words apart
+		static const bool TILED = LINE_LAYOUT::TILED;
+		static const size_t TILE_WIDTH = LINE_LAYOUT::ROW_WIDTH;
+		static const size_t TILE_PITCH = LINE_LAYOUT::ROW_PITCH;
+		static const size_t N_TILE_ROWS = (N_WORDS_PER_LINE / TILE_WIDTH);
 
 		static_assert((RD_ENABLED || WR_ENABLED),
 				"RD_ENABLED and/or WR_ENABLED must be true");
 		static_assert((PORTS > 0), "PORTS must be greater than 0");
 		static_assert((!(WR_ENABLED && (PORTS > 1))),
 				"PORTS must be equal to 1 when WR_ENABLED is true");
-		static_assert(((MAIN_SIZE > 0) && ((1 << ADDR_SIZE) == MAIN_SIZE)),
-				"MAIN_SIZE must be a power of 2 greater than 0");
+		static_assert((MAIN_SIZE > 0), "MAIN_SIZE must be greater than 0");
 		static_assert(((N_SETS > 0) && ((1 << SET_SIZE) == N_SETS)),
 				"N_SETS must be a power of 2 greater than 0");
 		static_assert(((N_WAYS > 0) && ((1 << WAY_SIZE) == N_WAYS)),
@@ -78,14 +180,55 @@ class cache {
 		static_assert(((N_WORDS_PER_LINE > 0) &&
 					((1 << OFF_SIZE) == N_WORDS_PER_LINE)),
 				"N_WORDS_PER_LINE must be a power of 2 greater than 0");
-		static_assert((MAIN_SIZE >= (N_SETS * N_WAYS * N_WORDS_PER_LINE)),
+		static_assert(((static_cast<size_t>(1) << ARRAY_ADDR_SIZE) >=
+					(N_SETS * N_WAYS * N_WORDS_PER_LINE)),
 				"N_SETS and/or N_WAYS and/or N_WORDS_PER_LINE are too big for the specified MAIN_SIZE");
-
-		typedef address<ADDR_SIZE, TAG_SIZE, SET_SIZE, WAY_SIZE, SWAP_TAG_SET>
-			address_type;
+		static_assert(((N_SECTORS > 0) &&
+					((1 << utils::log2_ceil(N_SECTORS)) == N_SECTORS) &&
+					(N_SECTORS <= N_WORDS_PER_LINE)),
+				"N_SECTORS must be a power of 2 greater than 0 and not greater than N_WORDS_PER_LINE");
+		static_assert(((AXI_WIDTH == 0) || ((AXI_WIDTH >= WORD_SIZE) &&
+						((N_WORDS_PER_BEAT * WORD_SIZE) == AXI_WIDTH) &&
+						((1 << BEAT_OFF_SIZE) == N_WORDS_PER_BEAT))),
+				"AXI_WIDTH must be 0 or a power of 2 multiple of the word size");
+		static_assert(((MEM_PORTS > 0) && ((1 << MEM_PORT_SIZE) == MEM_PORTS)),
+				"MEM_PORTS must be a power of 2 greater than 0");
+		// lines are interleaved across memory ports: adjacent lines
+		// sharing a beat would be read-modified-written concurrently
+		static_assert(((MEM_PORTS == 1) || (AXI_WIDTH == 0) ||
+					(N_WORDS_PER_LINE >= N_WORDS_PER_BEAT)),
+				"lines must not be narrower than an AXI beat when MEM_PORTS is greater than 1");
+		static_assert((N_ARRAYS > 0), "N_ARRAYS must be greater than 0");
+		static_assert((!ATOMIC || WR_ENABLED),
+				"WR_ENABLED must be true when ATOMIC is true");
+		static_assert((!TILED || (!WINDOWED && !PRELOAD)),
+				"WINDOWED and PRELOAD must be false with a tiled LINE_LAYOUT");
+		static_assert((!TILED || ((MAIN_SIZE % (TILE_PITCH * N_TILE_ROWS)) == 0)),
+				"MAIN_SIZE must be a multiple of a row of tiles with a tiled LINE_LAYOUT");
+		static_assert((!TILED || ((N_WORDS_PER_SECTOR % TILE_WIDTH) == 0)),
+				"sectors must be made of whole tile rows with a tiled LINE_LAYOUT");
+		static_assert((!TILED || ((TILE_WIDTH % N_WORDS_PER_BEAT) == 0)),
+				"tile rows must be made of whole AXI beats with a tiled LINE_LAYOUT");
+
+		typedef address<ADDR_SIZE, TAG_SIZE, SET_SIZE, WAY_SIZE, SWAP_TAG_SET,
+			SET_HASH> address_type;
+		typedef T data_type;
 		typedef T line_type[N_WORDS_PER_LINE];
-		typedef l1_cache<T, MAIN_SIZE, N_L1_SETS, N_L1_WAYS,
-			N_WORDS_PER_LINE, SWAP_TAG_SET, L1_STORAGE_IMPL> l1_cache_type;
+		typedef T sector_type[N_WORDS_PER_SECTOR];
+		typedef ap_uint<N_SECTORS> sectors_mask_type;
+		// masks of the words of a line/sector to be written
+		typedef ap_uint<N_WORDS_PER_LINE> line_words_mask_type;
+		typedef ap_uint<N_WORDS_PER_SECTOR> sector_words_mask_type;
+		typedef ap_uint<ATOMIC ? 4 : 1> update_type;
+		typedef ap_uint<(SECTOR_OFF_SIZE > 0) ? SECTOR_OFF_SIZE : 1>
+			sector_off_type;
+		typedef ap_uint<(AXI_WIDTH > 0) ? AXI_WIDTH : 1> beat_type;
+		typedef ap_uint<N_WORDS_PER_BEAT> beat_mask_type;
+		// main memory is accessed either word by word or in full beats
+		typedef typename std::conditional<(AXI_WIDTH > 0), beat_type, T>::type
+			mem_type;
+		typedef l1_cache<T, ADDR_SPACE_SIZE, N_L1_SETS, N_L1_WAYS,
+			N_WORDS_PER_SECTOR, SWAP_TAG_SET, L1_STORAGE_IMPL> l1_cache_type;
 		typedef raw_cache<T, (N_SETS * N_WAYS), N_WORDS_PER_LINE, 2>
 			raw_cache_type;
 		typedef replacer<LRU, address_type, N_SETS, N_WAYS,
@@ -95,9 +238,13 @@ class cache {
 			READ_OP 	= 1,
 			WRITE_OP 	= 2,
 			READ_WRITE_OP 	= 3,
+			WINDOW_OP 	= 4,
+			PRELOAD_OP 	= 5,
+			UNLOCK_OP 	= 6,
 			STOP_OP 	= 0
 		};
-		typedef ap_uint<1 + WR_ENABLED> op_type;
+		typedef ap_uint<(WINDOWED || RESIDENT || PRELOAD) ? 3 :
+			(1 + WR_ENABLED)> op_type;
 
 #ifndef __SYNTHESIS__
 		typedef enum {
@@ -105,21 +252,40 @@ class cache {
 			HIT,
 			L1_HIT
 		} hit_status_type;
+
+		typedef hit_status_type exec_status_type;
+#else
+		typedef void exec_status_type;
 #endif /* __SYNTHESIS__ */
 
-		template <bool WR_EN, size_t ADDR_SZ> struct op_struct {};
-		template <size_t ADDR_SZ>
-			struct op_struct<false, ADDR_SZ> {
+		// write requests carry a whole sector and a word mask only
+		// with LINE_WRITES, otherwise a single word
+		template <bool WR_EN, bool LINE_WR, size_t ADDR_SZ>
+			struct op_struct {};
+		template <bool LINE_WR, size_t ADDR_SZ>
+			struct op_struct<false, LINE_WR, ADDR_SZ> {
 				op_type op;
 				ap_uint<ADDR_SZ> addr;
+				ap_uint<2> hint;
 			};
 		template <size_t ADDR_SZ>
-			struct op_struct<true, ADDR_SZ> {
+			struct op_struct<true, false, ADDR_SZ> {
 				op_type op;
 				ap_uint<ADDR_SZ> addr;
 				T data;
+				update_type update;
+				ap_uint<2> hint;
+			};
+		template <size_t ADDR_SZ>
+			struct op_struct<true, true, ADDR_SZ> {
+				op_type op;
+				ap_uint<ADDR_SZ> addr;
+				sector_type data;
+				sector_words_mask_type mask;
+				update_type update;
+				ap_uint<2> hint;
 			};
-		typedef op_struct<WR_ENABLED, ADDR_SIZE> core_req_type;
+		typedef op_struct<WR_ENABLED, LINE_WRITES, ADDR_SIZE> core_req_type;
 
 		typedef struct {
 			op_type op;
@@ -129,41 +295,111 @@ class cache {
 		typedef struct {
 			ap_uint<ADDR_SIZE> write_back_addr;
 			line_type line;
+			sectors_mask_type valid_sectors;
+			bool last;
 		} mem_st_req_type;
 
-		ap_uint<(TAG_SIZE > 0) ? TAG_SIZE : 1> m_tag[N_SETS * N_WAYS];	// 0
-		ap_uint<N_SETS * N_WAYS> m_valid;				// 1
+		typedef struct {
+			size_t base;
+			size_t length;
+		} window_type;
+
+		typedef struct {
+			ap_uint<ADDR_SIZE> addr;
+			size_t n_lines;
+			bool pin;
+		} preload_req_type;
+
+		ap_uint<(TAG_SIZE > 0) ? TAG_SIZE : 1> m_tag[N_TAGGED_LINES];	// 0
+		ap_uint<N_TAGGED_LINES> m_valid;				// 1
 		ap_uint<N_SETS * N_WAYS> m_dirty;				// 2
-		T m_cache_mem[N_SETS * N_WAYS][N_WORDS_PER_LINE];		// 3
-		raw_cache_type m_raw_cache_core;				// 4
-		l1_cache_type m_l1_cache_get[PORTS];				// 5
-		replacer_type m_replacer;					// 6
-		unsigned int m_core_port;					// 7
+		ap_uint<N_SETS> m_dirty_set;					// 3
+		sectors_mask_type m_valid_sectors[N_TAGGED_LINES];		// 4
+		T m_cache_mem[N_SETS * N_WAYS][N_WORDS_PER_LINE];		// 5
+		raw_cache_type m_raw_cache_core;				// 6
+		l1_cache_type m_l1_cache_get[PORTS];				// 7
+		replacer_type m_replacer;					// 8
+		unsigned int m_core_port;					// 9
+		ap_uint<N_SETS * N_WAYS> m_pinned;				// 10
 #ifdef __SYNTHESIS__
-		hls::stream<core_req_type, (LATENCY * PORTS)> m_core_req[PORTS];// 8
-		sliced_stream<T, N_WORDS_PER_LINE, (LATENCY * PORTS)>
-			m_core_resp[PORTS];					// 9
-		hls::stream<mem_req_type, 2> m_mem_req;				// 10
-		hls::stream<mem_st_req_type, 2> m_mem_st_req;			// 11
-		sliced_stream<T, N_WORDS_PER_LINE, 2> m_mem_resp;		// 12
+		hls::stream<core_req_type, (LATENCY * PORTS)> m_core_req[PORTS];// 11
+		sliced_stream<T, N_WORDS_PER_SECTOR, (LATENCY * PORTS)>
+			m_core_resp[PORTS];					// 12
+		hls::stream<mem_req_type, 2> m_mem_req[MEM_PORTS];		// 13
+		hls::stream<mem_st_req_type, 2> m_mem_st_req[MEM_PORTS];	// 14
+		sliced_stream<T, N_WORDS_PER_SECTOR, 2> m_mem_resp[MEM_PORTS];	// 15
+		hls::stream<window_type, 1> m_core_window;			// 16
+		hls::stream<window_type, 1> m_mem_window[MEM_PORTS];		// 17
+		hls::stream<preload_req_type, 1> m_core_preload;		// 18
+		hls::stream<size_t, 1> m_mem_preload[MEM_PORTS];		// 19
+		hls::stream<core_req_type, PREFETCH_DEPTH> m_core_prefetch;	// 20
+		hls::stream<sector_off_type, MAX_OUTSTANDING>
+			m_pending_off[PORTS];					// 21
+		hls::stream<core_req_type, MAX_OUTSTANDING>
+			m_core_issue[PORTS];					// 22
 #else
-		T * const m_main_mem;
+		mem_type *m_main_mem[MEM_PORTS][N_ARRAYS];
+		window_type m_window = {0, MAIN_SIZE};
+		size_t m_array_size[N_ARRAYS];
 		int m_n_reqs[PORTS] = {0};
 		int m_n_hits[PORTS] = {0};
 		int m_n_l1_reqs[PORTS] = {0};
 		int m_n_l1_hits[PORTS] = {0};
 		std::mutex m_core_mutex;
+		std::queue<T> m_pending[PORTS];
+		std::mutex m_pending_mutex;
+		std::condition_variable m_pending_cv;
 #endif /* __SYNTHESIS__ */
 
 	public:
+		/**
+		 * \brief		Build a cache with a single memory port,
+		 * 			caching a single array.
+		 *
+		 * \param[in] main_mem	The pointer to the main memory.
+		 */
+		cache(mem_type * const main_mem): cache(&main_mem) {
+			static_assert(((MEM_PORTS == 1) && (N_ARRAYS == 1)),
+					"MEM_PORTS * N_ARRAYS pointers to the main memory are required");
+		}
+
+		/**
+		 * \brief		Build a cache with \p MEM_PORTS memory
+		 * 			ports, caching \p N_ARRAYS arrays.
+		 *
+		 * \param[in] main_mem	The pointers to the main memory:
+		 * 			\p N_ARRAYS (one for each array) for
+		 * 			each memory port. Pointers associated
+		 * 			with the same memory port must share
+		 * 			the same AXI port, while each memory
+		 * 			port must be associated with a dedicated
+		 * 			AXI port (pointers to the same array from
+		 * 			different memory ports can be aliases).
+		 * \param[in] array_size	The number of elements of each
+		 * 				array (not greater than
+		 * 				MAIN_SIZE): words beyond them are
+		 * 				never read nor written. All arrays
+		 * 				are MAIN_SIZE long if omitted.
+		 */
 #ifdef __SYNTHESIS__
-		cache(T * const main_mem) {
+		cache(mem_type * const main_mem[MEM_PORTS * N_ARRAYS],
+				const size_t array_size[N_ARRAYS] = nullptr) {
 #pragma HLS array_reshape variable=m_cache_mem type=complete dim=2
 #pragma HLS array_partition variable=m_tag type=complete dim=0
+#pragma HLS array_partition variable=m_valid_sectors type=complete dim=0
 			if (PORTS > 1) {
 #pragma HLS array_partition variable=m_core_req type=complete dim=0
 #pragma HLS array_partition variable=m_core_resp type=complete dim=0
 #pragma HLS array_partition variable=m_l1_cache_get type=complete dim=1
+#pragma HLS array_partition variable=m_pending_off type=complete dim=0
+#pragma HLS array_partition variable=m_core_issue type=complete dim=0
+			}
+			if (MEM_PORTS > 1) {
+#pragma HLS array_partition variable=m_mem_req type=complete dim=0
+#pragma HLS array_partition variable=m_mem_st_req type=complete dim=0
+#pragma HLS array_partition variable=m_mem_resp type=complete dim=0
+#pragma HLS array_partition variable=m_mem_window type=complete dim=0
+#pragma HLS array_partition variable=m_mem_preload type=complete dim=0
 			}
 
 			switch (L2_STORAGE_IMPL) {
@@ -180,10 +416,32 @@ class cache {
 					break;
 			}
 
-			run(main_mem);
+			size_t sizes[N_ARRAYS];
+#pragma HLS array_partition variable=sizes type=complete dim=0
+			for (size_t array = 0; array < N_ARRAYS; array++) {
+#pragma HLS unroll
+				sizes[array] = (array_size ? array_size[array] :
+						MAIN_SIZE);
+			}
+
+			run(main_mem, sizes);
 		}
 #else
-		cache(T * const main_mem): m_main_mem(main_mem) {}
+		cache(mem_type * const main_mem[MEM_PORTS * N_ARRAYS],
+				const size_t array_size[N_ARRAYS] = nullptr) {
+			for (size_t mem_port = 0; mem_port < MEM_PORTS; mem_port++) {
+				for (size_t array = 0; array < N_ARRAYS; array++) {
+					m_main_mem[mem_port][array] =
+						main_mem[(mem_port * N_ARRAYS) + array];
+				}
+			}
+
+			for (size_t array = 0; array < N_ARRAYS; array++) {
+				m_array_size[array] = (array_size ?
+						array_size[array] : MAIN_SIZE);
+				assert(m_array_size[array] <= MAIN_SIZE);
+			}
+		}
 #endif /* __SYNTHESIS__ */
 
 		/**
@@ -204,10 +462,16 @@ class cache {
 #ifndef __SYNTHESIS__
 				// invalidate all cache lines
 				m_valid = 0;
+				m_dirty_set = 0;
+				m_pinned = 0;
 
-				m_replacer.init();
+				if (!RESIDENT)
+					m_replacer.init();
 				if (RAW_CACHE)
 					m_raw_cache_core.init();
+
+				if (RESIDENT)
+					preload_all();
 #endif /* __SYNTHESIS__ */
 
 				m_core_port = 0;
@@ -222,16 +486,20 @@ class cache {
 		/**
 		 * \brief		Start cache internal processes.
 		 *
-		 * \param[in] main_mem	The pointer to the main memory.
+		 * \param[in] main_mem	The pointers to the main memory,
+		 * 			\p N_ARRAYS for each memory port.
+		 * \param[in] array_size	The number of elements of each
+		 * 				array.
 		 *
 		 * \note		This function must be before
 		 * 			the function in which cache is
 		 * 			accessed.
 		 */
-		void run(T * const main_mem) {
+		void run(mem_type * const main_mem[MEM_PORTS * N_ARRAYS],
+				const size_t array_size[N_ARRAYS]) {
 #pragma HLS inline
 			run_core();
-			run_mem_if(main_mem);
+			run_mem_ifs<0>(main_mem, array_size);
 		}
 #endif /* __SYNTHESIS__ */
 
@@ -251,15 +519,171 @@ class cache {
 #endif /* __SYNTHESIS__ */
 		}
 
+		/**
+		 * \brief		Move the window of main memory covered
+		 * 			by the cache (WINDOWED only).
+		 *
+		 * \param[in] base	The offset of the window in the buffer
+		 * 			pointed by main memory pointers (a
+		 * 			multiple of the AXI beat, if AXI_WIDTH
+		 * 			is not 0).
+		 * \param[in] length	The length of the window (not greater
+		 * 			than MAIN_SIZE).
+		 *
+		 * \note		Dirty lines are written back and all
+		 * 			lines are invalidated: must not be called
+		 * 			while accesses are pending.
+		 */
+		void set_window(const size_t base, const size_t length) {
+#pragma HLS inline
+			static_assert(WINDOWED, "set_window requires WINDOWED to be true");
+			const window_type window = {base, length};
+
+			if (L1_CACHE) {
+				for (size_t port = 0; port < PORTS; port++) {
+#pragma HLS unroll
+					m_l1_cache_get[port].init();
+				}
+			}
+
+#ifdef __SYNTHESIS__
+			core_req_type req;
+			req.op = WINDOW_OP;
+			m_core_req[0].write(req);
+			m_core_window.write(window);
+#else
+			assert(length <= MAIN_SIZE);
+			assert((base % N_WORDS_PER_BEAT) == 0);
+
+			std::unique_lock<std::mutex> lock(m_core_mutex);
+			flush();
+
+			// invalidate all cache lines
+			m_valid = 0;
+			m_pinned = 0;
+			if (!RESIDENT)
+				m_replacer.init();
+			if (RAW_CACHE)
+				m_raw_cache_core.init();
+
+			m_window = window;
+			if (RESIDENT)
+				preload_all();
+#endif /* __SYNTHESIS__ */
+		}
+
+		/**
+		 * \brief		Load the lines containing the elements
+		 * 			from \p begin to \p begin + \p len - 1
+		 * 			to the cache (PRELOAD only), with a
+		 * 			single burst for each memory port.
+		 *
+		 * \param[in] begin	The address in main memory of the first
+		 * 			element.
+		 * \param[in] len	The number of elements.
+		 * \param[in] pin	If true, the loaded lines are never
+		 * 			evicted (at least one way of each set is
+		 * 			left unpinned, so lines which would pin
+		 * 			the last one are just loaded).
+		 *
+		 * \note		Dirty lines are written back first: must
+		 * 			not be called while accesses are pending.
+		 * 			Pinned lines are released when the cache
+		 * 			is stopped or the window is moved.
+		 */
+		void preload(const ap_uint<ADDR_SIZE> begin, const size_t len,
+				const bool pin = false) {
+#pragma HLS inline
+			static_assert(PRELOAD, "preload requires PRELOAD to be true");
+			const size_t first_line = (static_cast<size_t>(begin) >> OFF_SIZE);
+			const size_t last_line =
+				((static_cast<size_t>(begin) + len - 1) >> OFF_SIZE);
+			const preload_req_type preload_req = {
+				(first_line << OFF_SIZE),
+				((len > 0) ? (last_line - first_line + 1) : 0),
+				pin
+			};
+
+#ifdef __SYNTHESIS__
+			core_req_type req;
+			req.op = PRELOAD_OP;
+			m_core_req[0].write(req);
+			m_core_preload.write(preload_req);
+#else
+			assert((len == 0) || (get_array(begin + (len - 1)) < N_ARRAYS));
+
+			std::unique_lock<std::mutex> lock(m_core_mutex);
+			flush();
+			preload_lines(preload_req);
+#endif /* __SYNTHESIS__ */
+		}
+
+		/**
+		 * \brief		Load and lock the lines containing the
+		 * 			elements from \p begin to
+		 * 			\p begin + \p len - 1 (PRELOAD only):
+		 * 			locked lines are never evicted, until
+		 * 			they are unlocked.
+		 *
+		 * \param[in] begin	The address in main memory of the first
+		 * 			element.
+		 * \param[in] len	The number of elements.
+		 *
+		 * \note		The same as \ref preload with \p pin
+		 * 			set to true: at least one way of each
+		 * 			set is left unlocked.
+		 */
+		void lock(const ap_uint<ADDR_SIZE> begin, const size_t len) {
+#pragma HLS inline
+			preload(begin, len, true);
+		}
+
+		/**
+		 * \brief		Unlock the lines containing the elements
+		 * 			from \p begin to \p begin + \p len - 1
+		 * 			(PRELOAD only), so that they can be
+		 * 			evicted again.
+		 *
+		 * \param[in] begin	The address in main memory of the first
+		 * 			element.
+		 * \param[in] len	The number of elements.
+		 *
+		 * \note		Must not be called while accesses are
+		 * 			pending.
+		 */
+		void unlock(const ap_uint<ADDR_SIZE> begin, const size_t len) {
+#pragma HLS inline
+			static_assert(PRELOAD, "unlock requires PRELOAD to be true");
+			const size_t first_line = (static_cast<size_t>(begin) >> OFF_SIZE);
+			const size_t last_line =
+				((static_cast<size_t>(begin) + len - 1) >> OFF_SIZE);
+			const preload_req_type unlock_req = {
+				(first_line << OFF_SIZE),
+				((len > 0) ? (last_line - first_line + 1) : 0),
+				false
+			};
+
+#ifdef __SYNTHESIS__
+			core_req_type req;
+			req.op = UNLOCK_OP;
+			m_core_req[0].write(req);
+			m_core_preload.write(unlock_req);
+#else
+			std::unique_lock<std::mutex> lock(m_core_mutex);
+			unlock_lines(unlock_req);
+#endif /* __SYNTHESIS__ */
+		}
+
 #ifdef __SYNTHESIS__
-		bool write_req(const core_req_type req, const unsigned int port) {
+		bool write_req(const core_req_type req, const unsigned int port,
+				bool dep = false) {
 #pragma HLS function_instantiate variable=port
-			return m_core_req[port].write_dep(req, false);
+			return m_core_req[port].write_dep(req, dep);
 		}
 
-		void read_resp(line_type line, bool dep, const unsigned int port) {
+		bool read_resp(sector_type sector, bool dep, const unsigned int port) {
 #pragma HLS function_instantiate variable=port
-			m_core_resp[port].read_dep(line, dep);
+			return m_core_resp[port].read_dep(sector, dep);
 		}
 #endif /* __SYNTHESIS__ */
 
@@ -270,17 +694,55 @@ class cache {
 		 * 			the cache line to be read.
 		 * \param[in] port	The port from which to read.
 		 * \param[out] line	The buffer to store the read line.
+		 * \param[in] hint	The access hint.
+		 *
+		 * \note		With sectored lines, one request per
+		 * 			sector is issued.
 		 */
 		void get_line(const ap_uint<ADDR_SIZE> addr_main,
-				const unsigned int port, line_type line) {
+				const unsigned int port, line_type line,
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			const ap_uint<ADDR_SIZE> line_addr =
+				((map_layout(addr_main) >> OFF_SIZE) << OFF_SIZE);
+
+			for (size_t sector = 0; sector < N_SECTORS; sector++) {
+				get_sector(unmap_layout(line_addr +
+							(sector * N_WORDS_PER_SECTOR)),
+						port,
+						&(line[sector * N_WORDS_PER_SECTOR]),
+						hint);
+			}
+		}
+
+		/**
+		 * \brief		Request to read the cache line sector
+		 * 			containing \p addr_main.
+		 *
+		 * \param[in] addr_main	The address in main memory belonging to
+		 * 			the sector to be read.
+		 * \param[in] port	The port from which to read.
+		 * \param[out] sector	The buffer to store the read sector.
+		 * \param[in] hint	The access hint.
+		 *
+		 * \note		Without sectored lines (N_SECTORS = 1)
+		 * 			the sector is the whole line.
+		 */
+		void get_sector(const ap_uint<ADDR_SIZE> addr_main,
+				const unsigned int port, sector_type sector,
+				const access_hint_type hint = INSERT_MRU) {
 #pragma HLS inline
 #ifndef __SYNTHESIS__
-			assert(addr_main < MAIN_SIZE);
+			assert(get_array(addr_main) < N_ARRAYS);
+			assert(get_array_addr(addr_main) < get_mem_size(m_window,
+						m_array_size[get_array(addr_main)]));
+			assert(!is_pending(port));
 #endif /* __SYNTHESIS__ */
+			const auto addr_line = map_layout(addr_main);
 
-			// try to get line from L1 cache
+			// try to get sector from L1 cache
 			const auto l1_hit = (L1_CACHE &&
-					m_l1_cache_get[port].get_line(addr_main, line));
+					m_l1_cache_get[port].get_line(addr_line, sector));
 
 #ifndef __SYNTHESIS__
 			auto hit_status = L1_HIT;
@@ -288,7 +750,8 @@ class cache {
 			if (!l1_hit) {
 				core_req_type req;
 				req.op = READ_OP;
-				req.addr = addr_main;
+				req.addr = addr_line;
+				req.hint = hint;
 
 #ifdef __SYNTHESIS__
 				// send read request to cache
@@ -296,18 +759,20 @@ class cache {
 				// force FIFO write and FIFO read to separate
 				// pipeline stages to avoid deadlock due to
 				// the blocking read
-				dep = utils::delay<LATENCY>(dep);
+				dep = utils::delay<RESP_LATENCY>(dep);
 
 				// read response from cache
-				read_resp(line, dep, port);
+				read_resp(sector, dep, port);
 #else
-				hit_status = exec_core_req(req, line);
+				line_type line;
+				hit_status = exec_core_req<RESIDENT>(req, line, port);
+				extract_sector(line, addr_line, sector);
 #endif /* __SYNTHESIS__ */
 			}
 
-			if (L1_CACHE) {
-				// store line to L1 cache
-				m_l1_cache_get[port].set_line(addr_main, line);
+			if (L1_CACHE && (hint != NO_ALLOCATE)) {
+				// store sector to L1 cache
+				m_l1_cache_get[port].set_line(addr_line, sector);
 			}
 
 #ifndef __SYNTHESIS__
@@ -315,6 +780,182 @@ class cache {
 #endif /* __SYNTHESIS__ */
 		}
 
+		/**
+		 * \brief		Request to read \p K consecutive data
+		 * 			elements, starting from \p addr_main.
+		 *
+		 * \param[in] addr_main	The address in main memory of the first
+		 * 			data element to be read.
+		 * \param[in] port	The port from which to read.
+		 * \param[out] span	The buffer to store the read data
+		 * 			elements.
+		 * \param[in] hint	The access hint.
+		 *
+		 * \note		\p addr_main does not need to be aligned:
+		 * 			the span is merged from the (at most
+		 * 			two) sectors it overlaps, with one
+		 * 			request per sector. It must not cross
+		 * 			the end of the array (or of the window).
+		 */
+		template <size_t K>
+		void get_span(const ap_uint<ADDR_SIZE> addr_main,
+				const unsigned int port, T span[K],
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			static_assert(((K > 0) && (K <= N_WORDS_PER_SECTOR)),
+					"K must be greater than 0 and not greater than the number of words per sector");
+			static_assert(!TILED, "span reads require a linear LINE_LAYOUT");
+
+			const ap_uint<ADDR_SIZE> sector_addr =
+				((addr_main >> SECTOR_OFF_SIZE) << SECTOR_OFF_SIZE);
+			const size_t off = (addr_main & (N_WORDS_PER_SECTOR - 1));
+
+			sector_type first;
+#pragma HLS array_partition variable=first type=complete dim=0
+			sector_type second;
+#pragma HLS array_partition variable=second type=complete dim=0
+			get_sector(sector_addr, port, first, hint);
+			// the following sector is read only if the
+			// span crosses the sector boundary
+			if ((off + K) > N_WORDS_PER_SECTOR) {
+				get_sector((sector_addr + N_WORDS_PER_SECTOR),
+						port, second, hint);
+			}
+
+			for (size_t i = 0; i < K; i++) {
+				const auto span_off = (off + i);
+				span[i] = ((span_off < N_WORDS_PER_SECTOR) ?
+						first[span_off & (N_WORDS_PER_SECTOR - 1)] :
+						second[span_off & (N_WORDS_PER_SECTOR - 1)]);
+			}
+		}
+
+		/**
+		 * \brief		Request to read \p K data elements at
+		 * 			arbitrary addresses.
+		 *
+		 * \param[in] addrs	The addresses in main memory of the data
+		 * 			elements to be read.
+		 * \param[in] port	The port from which to read.
+		 * \param[out] data	The buffer to store the read data
+		 * 			elements.
+		 * \param[in] hint	The access hint.
+		 *
+		 * \note		The requests are sent back to back, in
+		 * 			batches of up to LATENCY * PORTS, and
+		 * 			consecutive addresses belonging to the
+		 * 			same sector share a single request. The
+		 * 			L1 cache is not used, and the port must
+		 * 			not have outstanding requests.
+		 */
+		template <size_t K>
+		void gather(const ap_uint<ADDR_SIZE> addrs[K],
+				const unsigned int port, T data[K],
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			static_assert((K > 0), "K must be greater than 0");
+#ifndef __SYNTHESIS__
+			assert(!is_pending(port));
+#endif /* __SYNTHESIS__ */
+
+			ap_uint<ADDR_SIZE> addrs_line[K];
+#pragma HLS array_partition variable=addrs_line type=complete dim=0
+			for (size_t i = 0; i < K; i++)
+				addrs_line[i] = map_layout(addrs[i]);
+
+			// a request is sent only for the elements whose
+			// sector differs from the one of the previous element
+			bool is_new[K];
+#pragma HLS array_partition variable=is_new type=complete dim=0
+			for (size_t i = 0; i < K; i++) {
+				is_new[i] = ((i == 0) ||
+						((addrs_line[i] >> SECTOR_OFF_SIZE) !=
+						 (addrs_line[i - 1] >> SECTOR_OFF_SIZE)));
+			}
+
+			sector_type sector;
+#pragma HLS array_partition variable=sector type=complete dim=0
+#ifdef __SYNTHESIS__
+			auto dep = false;
+#endif /* __SYNTHESIS__ */
+			for (size_t first = 0; first < K; first += MAX_OUTSTANDING) {
+				const size_t last = (((first + MAX_OUTSTANDING) < K) ?
+						(first + MAX_OUTSTANDING) : K);
+#ifdef __SYNTHESIS__
+				// send the batch of requests
+				for (size_t i = first; i < last; i++) {
+					if (is_new[i]) {
+						core_req_type req;
+						req.op = READ_OP;
+						req.addr = addrs_line[i];
+						req.hint = hint;
+						dep = write_req(req, port, dep);
+					}
+				}
+				// force FIFO writes and FIFO reads to separate
+				// pipeline stages to avoid deadlock due to
+				// the blocking reads
+				dep = utils::delay<RESP_LATENCY>(dep);
+#endif /* __SYNTHESIS__ */
+
+				// read the responses
+				for (size_t i = first; i < last; i++) {
+					if (is_new[i]) {
+#ifdef __SYNTHESIS__
+						dep = read_resp(sector, dep, port);
+#else
+						assert(get_array(addrs[i]) < N_ARRAYS);
+						assert(get_array_addr(addrs[i]) < get_mem_size(m_window,
+									m_array_size[get_array(addrs[i])]));
+
+						core_req_type req;
+						req.op = READ_OP;
+						req.addr = addrs_line[i];
+						req.hint = hint;
+						line_type line;
+						const auto hit_status =
+							exec_core_req<RESIDENT>(req, line, port);
+						extract_sector(line, addrs_line[i], sector);
+						update_profiling(hit_status, port);
+#endif /* __SYNTHESIS__ */
+					}
+
+					data[i] = sector[addrs_line[i] &
+						(N_WORDS_PER_SECTOR - 1)];
+				}
+			}
+		}
+
+		/**
+		 * \brief		Request to read \p K data elements
+		 * 			spaced by \p stride, starting from
+		 * 			\p addr_main.
+		 *
+		 * \param[in] addr_main	The address in main memory of the first
+		 * 			data element to be read.
+		 * \param[in] stride	The distance between consecutive data
+		 * 			elements.
+		 * \param[in] port	The port from which to read.
+		 * \param[out] data	The buffer to store the read data
+		 * 			elements.
+		 * \param[in] hint	The access hint.
+		 *
+		 * \note		The requests are sent as with
+		 * 			\ref gather.
+		 */
+		template <size_t K>
+		void get_strided(const ap_uint<ADDR_SIZE> addr_main,
+				const size_t stride, const unsigned int port,
+				T data[K], const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			ap_uint<ADDR_SIZE> addrs[K];
+#pragma HLS array_partition variable=addrs type=complete dim=0
+			for (size_t i = 0; i < K; i++)
+				addrs[i] = (addr_main + (i * stride));
+
+			gather<K>(addrs, port, data, hint);
+		}
+
 		/**
 		 * \brief		Request to read a data element from a
 		 * 			specific port.
@@ -322,21 +963,23 @@ class cache {
 		 * \param[in] addr_main	The address in main memory referring to
 		 * 			the data element to be read.
 		 * \param[in] port	The port from which to read.
+		 * \param[in] hint	The access hint.
 		 *
 		 * \return		The read data element.
 		 */
-		T get(const ap_uint<ADDR_SIZE> addr_main, const unsigned int port) {
+		T get(const ap_uint<ADDR_SIZE> addr_main, const unsigned int port,
+				const access_hint_type hint = INSERT_MRU) {
 #pragma HLS inline
-			line_type line;
-#pragma HLS array_partition variable=line type=complete dim=0
+			sector_type sector;
+#pragma HLS array_partition variable=sector type=complete dim=0
 
-			// get the whole cache line
-			get_line(addr_main, port, line);
+			// get the cache line sector
+			get_sector(addr_main, port, sector, hint);
 
 			// extract information from address
-			address_type addr(addr_main);
+			address_type addr(map_layout(addr_main));
 
-			return line[addr.m_off];
+			return sector[addr.m_off & (N_WORDS_PER_SECTOR - 1)];
 		}
 
 		/**
@@ -344,90 +987,697 @@ class cache {
 		 *
 		 * \param[in] addr_main	The address in main memory referring to
 		 * 			the data element to be read.
+		 * \param[in] hint	The access hint.
 		 *
 		 * \return		The read data element.
+		 *
+		 * \note		The port is selected according to
+		 * 			\p PORT_POLICY.
 		 */
-		T get(const ap_uint<ADDR_SIZE> addr_main) {
+		T get(const ap_uint<ADDR_SIZE> addr_main,
+				const access_hint_type hint = INSERT_MRU) {
 #pragma HLS inline
-			const auto data = get(addr_main, m_core_port);
-			m_core_port = ((m_core_port + 1) % PORTS);
-
-			return data;
+			return get(addr_main, get_port(addr_main), hint);
 		}
 
 		/**
-		 * \brief		Request to write a data element.
+		 * \brief		Issue a request to read a data element
+		 * 			from a specific port, without waiting
+		 * 			for the response.
 		 *
 		 * \param[in] addr_main	The address in main memory referring to
-		 * 			the data element to be written.
-		 * \param[in] data	The data to be written.
+		 * 			the data element to be read.
+		 * \param[in] port	The port from which to read.
+		 * \param[in] hint	The access hint.
+		 *
+		 * \note		The read data elements are returned by
+		 * 			\ref collect in order of request. At most
+		 * 			LATENCY * PORTS requests can be
+		 * 			outstanding on each port, and blocking
+		 * 			reads must not be issued from a port
+		 * 			with outstanding requests. The L1 cache
+		 * 			is not used.
+		 * \note		On read-only caches requests can be
+		 * 			issued by an address-generator process
+		 * 			other than the one collecting the
+		 * 			responses (see \ref cache_wrapper).
 		 */
-		void set(const ap_uint<ADDR_SIZE> addr_main, const T data) {
+		void issue_get(const ap_uint<ADDR_SIZE> addr_main,
+				const unsigned int port,
+				const access_hint_type hint = INSERT_MRU) {
 #pragma HLS inline
-#ifndef __SYNTHESIS__
-			assert(addr_main < MAIN_SIZE);
-#endif /* __SYNTHESIS__ */
+			core_req_type req;
+			req.op = READ_OP;
+			req.addr = map_layout(addr_main);
+			req.hint = hint;
 
-			if (L1_CACHE) {
-				// inform L1 caches about the writing
-				m_l1_cache_get[0].notify_write(addr_main);
+			// extract information from address
+			const address_type addr(req.addr);
+			const sector_off_type off = (addr.m_off & (N_WORDS_PER_SECTOR - 1));
+
+#ifdef __SYNTHESIS__
+			// on read-only caches issued requests have their own
+			// queue, so that they can come from another process;
+			// otherwise they must be ordered with writes
+			if (WR_ENABLED)
+				m_core_req[port].write(req);
+			else
+				m_core_issue[port].write(req);
+			m_pending_off[port].write(off);
+#else
+			assert(get_array(addr_main) < N_ARRAYS);
+			assert(get_array_addr(addr_main) < get_mem_size(m_window,
+						m_array_size[get_array(addr_main)]));
+
+			if (is_decoupled_thread()) {
+				// wait for a free slot, as the FIFOs would do
+				std::unique_lock<std::mutex> lock(m_pending_mutex);
+				m_pending_cv.wait(lock, [&] {
+						return (m_pending[port].size() <
+								MAX_OUTSTANDING);
+						});
+			} else {
+				std::lock_guard<std::mutex> lock(m_pending_mutex);
+				assert(m_pending[port].size() < MAX_OUTSTANDING);
 			}
 
-			// send write request to cache
-			core_req_type req = {WRITE_OP, addr_main, data};
+			line_type line;
+			const auto hit_status = exec_core_req<RESIDENT>(req, line, port);
+			sector_type sector;
+			extract_sector(line, req.addr, sector);
+			update_profiling(hit_status, port);
 
+			{
+				std::lock_guard<std::mutex> lock(m_pending_mutex);
+				m_pending[port].push(sector[off]);
+			}
+			m_pending_cv.notify_all();
+#endif /* __SYNTHESIS__ */
+		}
+
+		/**
+		 * \brief		Wait for the response to the oldest
+		 * 			request issued from a specific port by
+		 * 			\ref issue_get.
+		 *
+		 * \param[in] port	The port from which to read.
+		 *
+		 * \return		The read data element.
+		 */
+		T collect(const unsigned int port) {
+#pragma HLS inline
 #ifdef __SYNTHESIS__
-			m_core_req[0].write(req);
+			sector_type sector;
+#pragma HLS array_partition variable=sector type=complete dim=0
+			m_core_resp[port].read(sector);
+			sector_off_type off;
+			m_pending_off[port].read(off);
+
+			return sector[off];
 #else
-			line_type dummy;
-			const auto hit_status = exec_core_req(req, dummy);
-			update_profiling(hit_status, 0);
+			std::unique_lock<std::mutex> lock(m_pending_mutex);
+			if (is_decoupled_thread()) {
+				// wait for the response, as the FIFOs would do
+				m_pending_cv.wait(lock, [&] {
+						return !m_pending[port].empty();
+						});
+			} else {
+				assert(!m_pending[port].empty());
+			}
+			const auto data = m_pending[port].front();
+			m_pending[port].pop();
+			lock.unlock();
+			m_pending_cv.notify_all();
+
+			return data;
 #endif /* __SYNTHESIS__ */
 		}
 
+		/**
+		 * \brief		Request to write a data element.
+		 *
+		 * \param[in] addr_main	The address in main memory referring to
+		 * 			the data element to be written.
+		 * \param[in] data	The data to be written.
+		 * \param[in] hint	The access hint.
+		 */
+		void set(const ap_uint<ADDR_SIZE> addr_main, const T data,
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
 #ifndef __SYNTHESIS__
-		int get_n_reqs(const unsigned int port) const {
-			return m_n_reqs[port];
-		}
+			assert(get_array(addr_main) < N_ARRAYS);
+			assert(get_array_addr(addr_main) < get_mem_size(m_window,
+						m_array_size[get_array(addr_main)]));
+#endif /* __SYNTHESIS__ */
 
-		int get_n_hits(const unsigned int port) const {
-			return m_n_hits[port];
-		}
+			// extract information from address
+			const address_type addr(map_layout(addr_main));
 
-		int get_n_l1_reqs(const unsigned int port) const {
-			return m_n_l1_reqs[port];
-		}
+			// the data element is selected by the mask
+			sector_type sector;
+#pragma HLS array_partition variable=sector type=complete dim=0
+			for (size_t off = 0; off < N_WORDS_PER_SECTOR; off++)
+				sector[off] = data;
+			sector_words_mask_type mask = 0;
+			mask[addr.m_off & (N_WORDS_PER_SECTOR - 1)] = true;
 
-		int get_n_l1_hits(const unsigned int port) const {
-			return m_n_l1_hits[port];
+			set_sector(addr_main, sector, mask, hint);
 		}
 
-		double get_hit_ratio(const unsigned int port) const {
-			if (m_n_reqs[port] > 0)
-				return ((m_n_hits[port] + m_n_l1_hits[port]) /
-						static_cast<double>(m_n_reqs[port] +
-							m_n_l1_reqs[port]));
+		/**
+		 * \brief		Request to write a whole cache line.
+		 *
+		 * \param[in] addr_main	The address in main memory belonging to
+		 * 			the cache line to be written.
+		 * \param[in] line	The line to be written.
+		 * \param[in] hint	The access hint.
+		 *
+		 * \note		The line is not loaded from main memory
+		 * 			on a miss. With sectored lines, one
+		 * 			request per sector is issued.
+		 */
+		void set_line(const ap_uint<ADDR_SIZE> addr_main,
+				const line_type line,
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			set_line_masked(addr_main, line, ~line_words_mask_type(0),
+					hint);
+		}
 
-			return 0;
+		/**
+		 * \brief		Request to write the words of a cache
+		 * 			line selected by a mask.
+		 *
+		 * \param[in] addr_main	The address in main memory belonging to
+		 * 			the cache line to be written.
+		 * \param[in] line	The line to be written.
+		 * \param[in] mask	The mask of the words of \p line to be
+		 * 			written (bit i selects word i).
+		 * \param[in] hint	The access hint.
+		 *
+		 * \note		With sectored lines, one request per
+		 * 			sector with at least one word selected
+		 * 			is issued. Sectors whose words are all
+		 * 			selected are not loaded from main
+		 * 			memory on a miss.
+		 */
+		void set_line_masked(const ap_uint<ADDR_SIZE> addr_main,
+				const line_type line,
+				const line_words_mask_type mask,
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			static_assert(LINE_WRITES, "set_line requires LINE_WRITES to be true");
+			const ap_uint<ADDR_SIZE> line_addr =
+				((map_layout(addr_main) >> OFF_SIZE) << OFF_SIZE);
+
+			for (size_t sector = 0; sector < N_SECTORS; sector++) {
+				const sector_words_mask_type sector_mask =
+					(mask >> (sector * N_WORDS_PER_SECTOR));
+				if (sector_mask != 0) {
+					set_sector(unmap_layout(line_addr +
+								(sector * N_WORDS_PER_SECTOR)),
+							&(line[sector * N_WORDS_PER_SECTOR]),
+							sector_mask, hint);
+				}
+			}
+		}
+
+		/**
+		 * \brief		Request to update a data element with
+		 * 			the result of \p op on its value and
+		 * 			\p operand.
+		 *
+		 * \param[in] addr_main	The address in main memory referring to
+		 * 			the data element to be updated.
+		 * \param[in] op	The operation.
+		 * \param[in] operand	The operand.
+		 * \param[in] hint	The access hint.
+		 *
+		 * \note		With ATOMIC, the update is a single
+		 * 			request executed in the cache, without
+		 * 			response. Otherwise, the data element
+		 * 			is read and then written.
+		 */
+		void update(const ap_uint<ADDR_SIZE> addr_main,
+				const update_op_type op, const T operand,
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			static_assert((ATOMIC || (RD_ENABLED && WR_ENABLED)),
+					"update requires ATOMIC, or RD_ENABLED and WR_ENABLED to be true");
+			if (ATOMIC) {
+#ifndef __SYNTHESIS__
+				assert(get_array(addr_main) < N_ARRAYS);
+				assert(get_array_addr(addr_main) < get_mem_size(m_window,
+							m_array_size[get_array(addr_main)]));
+#endif /* __SYNTHESIS__ */
+
+				// extract information from address
+				const address_type addr(map_layout(addr_main));
+
+				sector_type sector;
+#pragma HLS array_partition variable=sector type=complete dim=0
+				for (size_t off = 0; off < N_WORDS_PER_SECTOR; off++)
+					sector[off] = operand;
+				sector_words_mask_type mask = 0;
+				mask[addr.m_off & (N_WORDS_PER_SECTOR - 1)] = true;
+
+				set_sector(addr_main, sector, mask, hint, op);
+			} else {
+				set(addr_main, update_word<true>(op,
+							get(addr_main, 0, hint), operand),
+						hint);
+			}
+		}
+
+		/**
+		 * \brief		Request to update a data element as
+		 * 			with \ref update, returning its value
+		 * 			before the update.
+		 *
+		 * \param[in] addr_main	The address in main memory referring to
+		 * 			the data element to be updated.
+		 * \param[in] op	The operation.
+		 * \param[in] operand	The operand.
+		 * \param[in] hint	The access hint.
+		 *
+		 * \return		The value of the data element before
+		 * 			the update.
+		 */
+		T fetch_update(const ap_uint<ADDR_SIZE> addr_main,
+				const update_op_type op, const T operand,
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			static_assert((ATOMIC || (RD_ENABLED && WR_ENABLED)),
+					"fetch_update requires ATOMIC, or RD_ENABLED and WR_ENABLED to be true");
+			if (!ATOMIC) {
+				const auto data = get(addr_main, 0, hint);
+				set(addr_main, update_word<true>(op, data, operand), hint);
+
+				return data;
+			}
+
+#ifndef __SYNTHESIS__
+			assert(get_array(addr_main) < N_ARRAYS);
+			assert(get_array_addr(addr_main) < get_mem_size(m_window,
+						m_array_size[get_array(addr_main)]));
+#endif /* __SYNTHESIS__ */
+
+			const auto addr_line = map_layout(addr_main);
+			if (L1_CACHE) {
+				// inform L1 caches about the writing
+				m_l1_cache_get[0].notify_write(addr_line);
+			}
+
+			// extract information from address
+			const address_type addr(addr_line);
+			const sector_off_type off = (addr.m_off & (N_WORDS_PER_SECTOR - 1));
+
+			sector_type operands;
+#pragma HLS array_partition variable=operands type=complete dim=0
+			for (size_t i = 0; i < N_WORDS_PER_SECTOR; i++)
+				operands[i] = operand;
+			sector_words_mask_type mask = 0;
+			mask[off] = true;
+
+			core_req_type req;
+			req.op = READ_WRITE_OP;
+			req.addr = addr_line;
+			set_req_data<LINE_WRITES>(req, operands, mask);
+			req.update = op;
+			req.hint = hint;
+
+			sector_type sector;
+#pragma HLS array_partition variable=sector type=complete dim=0
+#ifdef __SYNTHESIS__
+			// send update request to cache
+			auto dep = write_req(req, 0);
+			// force FIFO write and FIFO read to separate
+			// pipeline stages to avoid deadlock due to
+			// the blocking read
+			dep = utils::delay<RESP_LATENCY>(dep);
+
+			// read response from cache
+			read_resp(sector, dep, 0);
+#else
+			line_type line;
+			const auto hit_status = exec_core_req<RESIDENT>(req, line, 0);
+			extract_sector(line, addr_line, sector);
+			update_profiling(hit_status, 0);
+#endif /* __SYNTHESIS__ */
+
+			return sector[off];
+		}
+
+		/**
+		 * \brief		Request to write \p value to the
+		 * 			elements from \p addr_main to
+		 * 			\p addr_main + \p len - 1.
+		 *
+		 * \param[in] addr_main	The address in main memory of the first
+		 * 			element.
+		 * \param[in] len	The number of elements.
+		 * \param[in] value	The value to be written.
+		 *
+		 * \note		One write request for each line is
+		 * 			issued, so that whole lines are not
+		 * 			loaded from main memory.
+		 */
+		void fill(const ap_uint<ADDR_SIZE> addr_main, const size_t len,
+				const T value) {
+#pragma HLS inline
+			static_assert(!TILED, "fill requires a linear LINE_LAYOUT");
+			static_assert(LINE_WRITES, "fill requires LINE_WRITES to be true");
+			line_type line;
+#pragma HLS array_partition variable=line type=complete dim=0
+			for (size_t off = 0; off < N_WORDS_PER_LINE; off++)
+				line[off] = value;
+
+			const size_t first_line =
+				(static_cast<size_t>(addr_main) >> OFF_SIZE);
+			const size_t last_line =
+				((static_cast<size_t>(addr_main) + len - 1) >> OFF_SIZE);
+FILL_LOOP:		for (size_t line_id = first_line;
+					(len > 0) && (line_id <= last_line); line_id++) {
+#pragma HLS pipeline II=1
+				set_line_masked((line_id << OFF_SIZE), line,
+						get_range_mask(line_id, addr_main, len));
+			}
+		}
+
+		/**
+		 * \brief		Request to copy the elements from
+		 * 			\p addr_main to \p addr_main + \p len - 1
+		 * 			to the same addresses of \p dst.
+		 *
+		 * \param[in] dst	The destination cache (possibly this one).
+		 * \param[in] addr_main	The address in main memory of the first
+		 * 			element.
+		 * \param[in] len	The number of elements.
+		 *
+		 * \note		The elements are read and written one
+		 * 			line at a time.
+		 */
+		void copy(cache &dst, const ap_uint<ADDR_SIZE> addr_main,
+				const size_t len) {
+#pragma HLS inline
+			copy_lines(dst, addr_main, addr_main, len);
+		}
+
+		/**
+		 * \brief		Request to reduce the elements from
+		 * 			\p addr_main to \p addr_main + \p len - 1
+		 * 			with \p OP.
+		 *
+		 * \tparam OP		The operation (as for \ref update): one
+		 * 			of UPDATE_ADD, UPDATE_MIN, UPDATE_MAX,
+		 * 			UPDATE_AND, UPDATE_OR and UPDATE_XOR.
+		 * \param[in] addr_main	The address in main memory of the first
+		 * 			element.
+		 * \param[in] len	The number of elements.
+		 *
+		 * \return		The result of the reduction (T() if
+		 * 			\p len is 0).
+		 *
+		 * \note		The elements are read one line at a
+		 * 			time, and the words of each line are
+		 * 			reduced by a tree of operations, so
+		 * 			that only associative operations are
+		 * 			allowed.
+		 */
+		template <update_op_type OP>
+		T reduce(const ap_uint<ADDR_SIZE> addr_main, const size_t len) {
+#pragma HLS inline
+			static_assert(RD_ENABLED, "reduce requires RD_ENABLED to be true");
+			static_assert(!TILED, "reduce requires a linear LINE_LAYOUT");
+			static_assert(is_associative(OP),
+					"reduce requires an associative operation");
+			T acc = T();
+			auto is_acc = false;
+
+			const size_t first_line =
+				(static_cast<size_t>(addr_main) >> OFF_SIZE);
+			const size_t last_line =
+				((static_cast<size_t>(addr_main) + len - 1) >> OFF_SIZE);
+REDUCE_LOOP:		for (size_t line_id = first_line;
+					(len > 0) && (line_id <= last_line); line_id++) {
+#pragma HLS pipeline II=1
+				line_type line;
+#pragma HLS array_partition variable=line type=complete dim=0
+				get_line((line_id << OFF_SIZE), 0, line);
+				const auto mask = get_range_mask(line_id, addr_main, len);
+
+				// reduce the words of the line in the range
+				bool is_valid[N_WORDS_PER_LINE];
+#pragma HLS array_partition variable=is_valid type=complete dim=0
+				for (size_t off = 0; off < N_WORDS_PER_LINE; off++)
+					is_valid[off] = mask[off];
+				for (size_t width = (N_WORDS_PER_LINE / 2); width > 0;
+						width /= 2) {
+					for (size_t off = 0; off < width; off++) {
+						if (is_valid[off] && is_valid[off + width]) {
+							line[off] = update_word<true>(OP,
+									line[off], line[off + width]);
+						} else if (is_valid[off + width]) {
+							line[off] = line[off + width];
+						}
+						is_valid[off] |= is_valid[off + width];
+					}
+				}
+
+				acc = (is_acc ? update_word<true>(OP, acc, line[0]) :
+						line[0]);
+				is_acc = true;
+			}
+
+			return acc;
+		}
+
+		/**
+		 * \brief		Request to load in advance the line
+		 * 			containing \p addr_main (PREFETCH only).
+		 *
+		 * \param[in] addr_main	The address in main memory belonging to
+		 * 			the line to be loaded.
+		 *
+		 * \note		The request is only a hint: it is served
+		 * 			only when there are no pending requests,
+		 * 			and it is dropped if the queue of
+		 * 			prefetch requests is full, so that it
+		 * 			never stalls the caller (no data is
+		 * 			returned). C simulation serves every
+		 * 			request at once.
+		 */
+		void prefetch(const ap_uint<ADDR_SIZE> addr_main) {
+#pragma HLS inline
+			static_assert(PREFETCH, "prefetch requires PREFETCH to be true");
+			static_assert(RD_ENABLED, "prefetch requires RD_ENABLED to be true");
+#ifdef __SYNTHESIS__
+			core_req_type req;
+			req.op = READ_OP;
+			req.addr = map_layout(addr_main);
+			req.hint = INSERT_MRU;
+
+			m_core_prefetch.write_nb(req);
+#else
+			exec_prefetch(addr_main);
+#endif /* __SYNTHESIS__ */
+		}
+
+		/**
+		 * \brief		Request to load in advance the lines
+		 * 			containing the elements from
+		 * 			\p addr_main to \p addr_main + \p len - 1
+		 * 			(PREFETCH only).
+		 *
+		 * \param[in] addr_main	The address in main memory of the first
+		 * 			element.
+		 * \param[in] len	The number of elements.
+		 *
+		 * \note		One request for each line is issued,
+		 * 			as with \ref prefetch.
+		 */
+		void prefetch_range(const ap_uint<ADDR_SIZE> addr_main,
+				const size_t len) {
+#pragma HLS inline
+			static_assert(!TILED,
+					"prefetch_range requires a linear LINE_LAYOUT");
+			const size_t first_line =
+				(static_cast<size_t>(addr_main) >> OFF_SIZE);
+			const size_t last_line =
+				((static_cast<size_t>(addr_main) + len - 1) >> OFF_SIZE);
+PREFETCH_LOOP:		for (size_t line = first_line;
+					(len > 0) && (line <= last_line); line++) {
+#pragma HLS pipeline II=1
+				prefetch(line << OFF_SIZE);
+			}
+		}
+
+#ifndef __SYNTHESIS__
+		int get_n_reqs(const unsigned int port) const {
+			return m_n_reqs[port];
+		}
+
+		int get_n_hits(const unsigned int port) const {
+			return m_n_hits[port];
+		}
+
+		int get_n_l1_reqs(const unsigned int port) const {
+			return m_n_l1_reqs[port];
+		}
+
+		int get_n_l1_hits(const unsigned int port) const {
+			return m_n_l1_hits[port];
+		}
+
+		double get_hit_ratio(const unsigned int port) const {
+			if (m_n_reqs[port] > 0)
+				return ((m_n_hits[port] + m_n_l1_hits[port]) /
+						static_cast<double>(m_n_reqs[port] +
+							m_n_l1_reqs[port]));
+
+			return 0;
+		}
+#endif /* __SYNTHESIS__ */
+
+	private:
+		/**
+		 * \brief		Request to write the words of the cache
+		 * 			line sector containing \p addr_main
+		 * 			selected by \p mask.
+		 *
+		 * \param[in] addr_main	The address in main memory belonging to
+		 * 			the sector to be written.
+		 * \param[in] sector	The sector to be written.
+		 * \param[in] mask	The mask of the words of \p sector to
+		 * 			be written.
+		 * \param[in] hint	The access hint.
+		 * \param[in] update	The operation combining the written
+		 * 			word with the stored one (ATOMIC only).
+		 */
+		void set_sector(const ap_uint<ADDR_SIZE> addr_main,
+				const sector_type sector,
+				const sector_words_mask_type mask,
+				const access_hint_type hint,
+				const update_op_type update = UPDATE_SET) {
+#pragma HLS inline
+#ifndef __SYNTHESIS__
+			assert(get_array(addr_main) < N_ARRAYS);
+			assert(get_array_addr(addr_main) < get_mem_size(m_window,
+						m_array_size[get_array(addr_main)]));
+#endif /* __SYNTHESIS__ */
+
+			const auto addr_line = map_layout(addr_main);
+			if (L1_CACHE) {
+				// inform L1 caches about the writing
+				m_l1_cache_get[0].notify_write(addr_line);
+			}
+
+			// send write request to cache
+			core_req_type req;
+			req.op = WRITE_OP;
+			req.addr = addr_line;
+			set_req_data<LINE_WRITES>(req, sector, mask);
+			req.update = update;
+			req.hint = hint;
+
+#ifdef __SYNTHESIS__
+			m_core_req[0].write(req);
+#else
+			line_type dummy;
+			const auto hit_status = exec_core_req<RESIDENT>(req, dummy, 0);
+			update_profiling(hit_status, 0);
+#endif /* __SYNTHESIS__ */
+		}
+
+		/**
+		 * \brief		Return the mask of the words of the line
+		 * 			\p line_id belonging to the range from
+		 * 			\p addr_main to \p addr_main + \p len - 1.
+		 */
+		line_words_mask_type get_range_mask(const size_t line_id,
+				const ap_uint<ADDR_SIZE> addr_main,
+				const size_t len) const {
+#pragma HLS inline
+			const size_t begin = addr_main;
+			const size_t end = (begin + len);
+			line_words_mask_type mask;
+			for (size_t off = 0; off < N_WORDS_PER_LINE; off++) {
+				const size_t word = ((line_id << OFF_SIZE) + off);
+				mask[off] = ((word >= begin) && (word < end));
+			}
+
+			return mask;
+		}
+
+		/**
+		 * \brief		Copy \p len elements from \p src_addr
+		 * 			to \p dst_addr of \p dst, one line at a
+		 * 			time.
+		 *
+		 * \note		\p src_addr and \p dst_addr must have
+		 * 			the same offset in the line.
+		 */
+		void copy_lines(cache &dst, const ap_uint<ADDR_SIZE> dst_addr,
+				const ap_uint<ADDR_SIZE> src_addr, const size_t len) {
+#pragma HLS inline
+			static_assert(RD_ENABLED, "copy requires RD_ENABLED to be true");
+			static_assert(!TILED, "copy requires a linear LINE_LAYOUT");
+			static_assert(LINE_WRITES, "copy requires LINE_WRITES to be true");
+			const size_t first_line =
+				(static_cast<size_t>(src_addr) >> OFF_SIZE);
+			const size_t last_line =
+				((static_cast<size_t>(src_addr) + len - 1) >> OFF_SIZE);
+			const size_t dst_first_line =
+				(static_cast<size_t>(dst_addr) >> OFF_SIZE);
+COPY_LOOP:		for (size_t line_id = first_line;
+					(len > 0) && (line_id <= last_line); line_id++) {
+#pragma HLS pipeline II=1
+				line_type line;
+#pragma HLS array_partition variable=line type=complete dim=0
+				get_line((line_id << OFF_SIZE), 0, line);
+				dst.set_line_masked(((dst_first_line +
+								(line_id - first_line)) << OFF_SIZE),
+						line, get_range_mask(line_id, src_addr, len));
+			}
 		}
-#endif /* __SYNTHESIS__ */
 
-	private:
 		template <bool WR_EN>
 		typename std::enable_if<WR_EN, void>::type
 			write_cache(line_type line, const core_req_type &req,
 					const address_type &addr) {
 #pragma HLS inline
+				const auto first =
+					((addr.m_off >> SECTOR_OFF_SIZE) * N_WORDS_PER_SECTOR);
+				const T updated = get_updated_word(line, req, addr);
+				const sector_off_type updated_off =
+					(addr.m_off & (N_WORDS_PER_SECTOR - 1));
+				const auto mask = get_req_mask<LINE_WRITES>(req);
 				if (RAW_CACHE) {
-					// modify the line
-					line[addr.m_off] = req.data;
+					// modify a copy of the line, so that
+					// the line read is left for the response
+					line_type new_line;
+#pragma HLS array_partition variable=new_line type=complete dim=0
+					for (size_t off = 0; off < N_WORDS_PER_LINE; off++)
+						new_line[off] = line[off];
+					for (size_t off = 0; off < N_WORDS_PER_SECTOR; off++) {
+						if (mask[off]) {
+							new_line[first + off] =
+								((off == updated_off) ? updated :
+								 get_req_word<LINE_WRITES>(req, off));
+						}
+					}
 
 					// store the modified line to cache
 					m_raw_cache_core.set_line(m_cache_mem,
-							addr.m_addr_line, line);
+							addr.m_addr_line, new_line);
 				} else {
-					m_cache_mem[addr.m_addr_line][addr.m_off] =
-						req.data;
+					for (size_t off = 0; off < N_WORDS_PER_SECTOR; off++) {
+						if (mask[off]) {
+							m_cache_mem[addr.m_addr_line][first + off] =
+								((off == updated_off) ? updated :
+								 get_req_word<LINE_WRITES>(req, off));
+						}
+					}
 				}
 			}
 
@@ -436,331 +1686,1599 @@ class cache {
 			write_cache(line_type line, const core_req_type &req,
 					const address_type &addr) {
 #pragma HLS inline
-					(void)line;
-					(void)req;
-					(void)addr;
+					(void)line;
+					(void)req;
+					(void)addr;
+			}
+
+		/**
+		 * \brief		Write data elements to main memory
+		 * 			without allocating their line, by writing
+		 * 			back the loaded sector once modified.
+		 *
+		 * \param[in] line	The line containing the loaded sector.
+		 * \param[in] req	The write request.
+		 * \param[in] addr	The address of the request.
+		 */
+		template <bool WR_EN>
+		typename std::enable_if<WR_EN, void>::type
+			write_around(line_type line, const core_req_type &req,
+					const address_type &addr) {
+#pragma HLS inline
+				mem_st_req_type mem_st_req;
+				mem_st_req.write_back_addr =
+					((req.addr >> OFF_SIZE) << OFF_SIZE);
+				const auto sector = (addr.m_off >> SECTOR_OFF_SIZE);
+				const T updated = get_updated_word(line, req, addr);
+				const auto mask = get_req_mask<LINE_WRITES>(req);
+				for (size_t off = 0; off < N_WORDS_PER_LINE; off++) {
+					const auto sector_off = (off & (N_WORDS_PER_SECTOR - 1));
+					mem_st_req.line[off] = ((((off >> SECTOR_OFF_SIZE) == sector) &&
+								mask[sector_off]) ?
+							((off == addr.m_off) ? updated :
+							 get_req_word<LINE_WRITES>(req,
+								 sector_off)) :
+							line[off]);
+				}
+				mem_st_req.valid_sectors = 0;
+				mem_st_req.valid_sectors[addr.m_off >> SECTOR_OFF_SIZE] = true;
+				mem_st_req.last = true;
+
+#ifdef __SYNTHESIS__
+				mem_req_type mem_req = {WRITE_OP, 0};
+				m_mem_req[get_mem_port(req.addr)].write(mem_req);
+#endif /* __SYNTHESIS__ */
+				write_back(mem_st_req);
+			}
+
+		template <bool WR_EN>
+		typename std::enable_if<(!WR_EN), void>::type
+			write_around(line_type line, const core_req_type &req,
+					const address_type &addr) {
+#pragma HLS inline
+					(void)line;
+					(void)req;
+					(void)addr;
+			}
+
+		/**
+		 * \brief		Check if the write request \p req
+		 * 			overwrites a whole sector.
+		 */
+		template <bool WR_EN>
+		typename std::enable_if<WR_EN, bool>::type
+			is_full_write(const core_req_type &req) const {
+#pragma HLS inline
+				return ((req.op == WRITE_OP) &&
+						get_req_mask<LINE_WRITES>(req).and_reduce() &&
+						(!ATOMIC || (req.update == UPDATE_SET)));
+			}
+
+		template <bool WR_EN>
+		typename std::enable_if<(!WR_EN), bool>::type
+			is_full_write(const core_req_type &req) const {
+#pragma HLS inline
+				(void)req;
+				return false;
+			}
+
+		/**
+		 * \brief		Return the word addressed by the write
+		 * 			request \p req, once updated.
+		 *
+		 * \param[in] line	The line containing the stored word.
+		 * \param[in] req	The write request.
+		 * \param[in] addr	The address of the request.
+		 *
+		 * \return		The updated word (the written one,
+		 * 			unless ATOMIC).
+		 */
+		T get_updated_word(const line_type line, const core_req_type &req,
+				const address_type &addr) const {
+#pragma HLS inline
+			return update_word<ATOMIC>(static_cast<update_op_type>(
+						static_cast<unsigned int>(req.update)),
+					line[addr.m_off],
+					get_req_word<LINE_WRITES>(req,
+						(addr.m_off & (N_WORDS_PER_SECTOR - 1))));
+		}
+
+		/**
+		 * \brief		Store the words of \p sector selected by
+		 * 			\p mask in the write request \p req.
+		 *
+		 * \param[out] req	The write request, with its address set.
+		 * \param[in] sector	The words to be written.
+		 * \param[in] mask	The mask of the words of \p sector to
+		 * 			be written: without LINE_WRITES, only
+		 * 			the word addressed by \p req.
+		 */
+		template <bool LINE_WR>
+		typename std::enable_if<LINE_WR, void>::type
+			set_req_data(core_req_type &req, const sector_type sector,
+					const sector_words_mask_type mask) const {
+#pragma HLS inline
+				for (size_t off = 0; off < N_WORDS_PER_SECTOR; off++)
+					req.data[off] = sector[off];
+				req.mask = mask;
+			}
+
+		template <bool LINE_WR>
+		typename std::enable_if<(!LINE_WR), void>::type
+			set_req_data(core_req_type &req, const sector_type sector,
+					const sector_words_mask_type mask) const {
+#pragma HLS inline
+				const address_type addr(req.addr);
+				const sector_off_type off =
+					(addr.m_off & (N_WORDS_PER_SECTOR - 1));
+#ifndef __SYNTHESIS__
+				assert(mask == (sector_words_mask_type(1) << off));
+#else
+				(void)mask;
+#endif /* __SYNTHESIS__ */
+				req.data = sector[off];
+			}
+
+		/**
+		 * \brief		Return the mask of the words of the
+		 * 			sector written by \p req.
+		 */
+		template <bool LINE_WR>
+		typename std::enable_if<LINE_WR, sector_words_mask_type>::type
+			get_req_mask(const core_req_type &req) const {
+#pragma HLS inline
+				return req.mask;
+			}
+
+		template <bool LINE_WR>
+		typename std::enable_if<(!LINE_WR), sector_words_mask_type>::type
+			get_req_mask(const core_req_type &req) const {
+#pragma HLS inline
+				const address_type addr(req.addr);
+				sector_words_mask_type mask = 0;
+				mask[addr.m_off & (N_WORDS_PER_SECTOR - 1)] = true;
+
+				return mask;
+			}
+
+		/**
+		 * \brief		Return the word at offset \p off of the
+		 * 			sector written by \p req.
+		 */
+		template <bool LINE_WR>
+		typename std::enable_if<LINE_WR, T>::type
+			get_req_word(const core_req_type &req,
+					const sector_off_type off) const {
+#pragma HLS inline
+				return req.data[off];
+			}
+
+		template <bool LINE_WR>
+		typename std::enable_if<(!LINE_WR), T>::type
+			get_req_word(const core_req_type &req,
+					const sector_off_type off) const {
+#pragma HLS inline
+				(void)off;
+				return req.data;
+			}
+
+		/**
+		 * \brief		Combine \p operand with \p data.
+		 *
+		 * \param[in] op	The operation.
+		 * \param[in] data	The stored word.
+		 * \param[in] operand	The operand.
+		 *
+		 * \return		The result of the operation.
+		 */
+		template <bool UPDATE_EN>
+		static typename std::enable_if<UPDATE_EN, T>::type
+			update_word(const update_op_type op, const T data,
+					const T operand) {
+#pragma HLS inline
+				return apply_update<CUSTOM_UPDATE>(op, data, operand);
+			}
+
+		template <bool UPDATE_EN>
+		static typename std::enable_if<(!UPDATE_EN), T>::type
+			update_word(const update_op_type op, const T data,
+					const T operand) {
+#pragma HLS inline
+				(void)op;
+				(void)data;
+				return operand;
+			}
+
+		/**
+		 * \brief		Execute a request to a resident cache:
+		 * 			the line is always present, in the way
+		 * 			given by the tag, so neither tag lookup
+		 * 			nor replacement is needed.
+		 *
+		 * \param[in] req	The request.
+		 * \param[out] line	The buffer to store the accessed line.
+		 * \param[in] port	The port of the request.
+		 */
+		template <bool RES>
+		typename std::enable_if<RES, exec_status_type>::type
+			exec_core_req(core_req_type &req, line_type line,
+					const unsigned int port) {
+#pragma HLS inline
+			(void)port;
+#ifndef __SYNTHESIS__
+			std::unique_lock<std::mutex> lock(m_core_mutex);
+#endif /* __SYNTHESIS__ */
+
+			// check the request type
+			const auto read = ((RD_ENABLED && (req.op == READ_OP)) ||
+					(!WR_ENABLED));
+
+			// extract information from address
+			address_type addr(req.addr);
+			addr.set_way(addr.m_tag);
+
+			// read from cache memory
+			if (RAW_CACHE) {
+				m_raw_cache_core.get_line(m_cache_mem,
+						addr.m_addr_line, line);
+			} else {
+				for (size_t off = 0; off < N_WORDS_PER_LINE; off++)
+					line[off] = m_cache_mem[addr.m_addr_line][off];
+			}
+
+			if (!read) {
+				write_cache<WR_ENABLED>(line, req, addr);
+
+				m_dirty[addr.m_addr_line] = true;
+				m_dirty_set[addr.m_set] = true;
+			}
+
+#ifndef __SYNTHESIS__
+			lock.unlock();
+			return HIT;
+#endif /* __SYNTHESIS__ */
+		}
+
+		/**
+		 * \brief		Execute a request, loading the accessed
+		 * 			sector from main memory on a miss.
+		 *
+		 * \param[in] req	The request.
+		 * \param[out] line	The buffer to store the accessed line.
+		 * \param[in] port	The port of the request, whose ways
+		 * 			are the only ones in which the line can
+		 * 			be inserted on a miss.
+		 */
+		template <bool RES>
+		typename std::enable_if<(!RES), exec_status_type>::type
+			exec_core_req(core_req_type &req, line_type line,
+					const unsigned int port) {
+#pragma HLS inline
+#ifndef __SYNTHESIS__
+			std::unique_lock<std::mutex> lock(m_core_mutex);
+#endif /* __SYNTHESIS__ */
+
+			// check the request type
+			const auto read = ((RD_ENABLED && (req.op == READ_OP)) ||
+					(!WR_ENABLED));
+
+			// a write of a whole sector does not need to load it
+			const auto full_write = (!read &&
+					is_full_write<WR_ENABLED>(req));
+
+			// extract information from address
+			address_type addr(req.addr);
+			const auto sector = (addr.m_off >> SECTOR_OFF_SIZE);
+
+			auto way = hit(addr);
+			const auto tag_hit = (way != -1);
+			// the line can be inserted only in the unpinned
+			// ways of the partition of the port
+			const ap_uint<N_WAYS> excluded_ways = (get_pinned_ways(addr) |
+					~WAY_PARTITION::template get_ways<N_WAYS, PORTS>(port));
+			// on a miss, NO_ALLOCATE accesses bypass the cache, as
+			// those for which all the ways are excluded
+			const auto allocate = (tag_hit || ((req.hint != NO_ALLOCATE) &&
+						!excluded_ways.and_reduce()));
+
+			if (!tag_hit)
+				way = m_replacer.get_way(addr, excluded_ways);
+
+			addr.set_way(way);
+			// lines inserted with INSERT_LRU are left
+			// as the next ones to be replaced
+			if (tag_hit || (allocate && (req.hint == INSERT_MRU)))
+				m_replacer.notify_use(addr);
+
+			// with sectored lines, the line may be allocated
+			// without the requested sector being loaded
+			const auto is_hit = (tag_hit && ((N_SECTORS == 1) ||
+						m_valid_sectors[addr.m_addr_line][sector]));
+
+			mem_req_type mem_req;
+			mem_st_req_type mem_st_req;
+			typename address_type::addr_line_type addr_cache_rd = addr.m_addr_line;
+			if (!is_hit) {
+				// read from main memory
+				mem_req.op = READ_OP;
+				mem_req.load_addr = addr.m_addr_main;
+
+				// check if write back is necessary
+				if (WR_ENABLED && !tag_hit && allocate &&
+						m_valid[addr.m_addr_line] &&
+						m_dirty[addr.m_addr_line]) {
+					// build write-back address
+					address_type write_back_addr(m_tag[addr.m_addr_line],
+							addr.m_set, 0, addr.m_way);
+					addr_cache_rd = write_back_addr.m_addr_line;
+					mem_req.op = READ_WRITE_OP;
+					mem_st_req.write_back_addr = write_back_addr.m_addr_main;
+					mem_st_req.valid_sectors =
+						get_valid_sectors(addr.m_addr_line);
+					mem_st_req.last = true;
+				}
+			}
+
+			// mem_req.op is READ_WRITE_OP only in case of write back
+			if (tag_hit || (mem_req.op == READ_WRITE_OP)) {
+				// read from cache memory (on a sector miss, the
+				// line is read to be merged with the loaded sector)
+				if (RAW_CACHE) {
+					m_raw_cache_core.get_line(m_cache_mem,
+							addr_cache_rd,
+							tag_hit ? line : mem_st_req.line);
+				} else {
+					if (tag_hit) {
+						for (size_t off = 0; off < N_WORDS_PER_LINE; off++)
+							line[off] = m_cache_mem[addr_cache_rd][off];
+					} else {
+						for (size_t off = 0; off < N_WORDS_PER_LINE; off++)
+							mem_st_req.line[off] = m_cache_mem[addr_cache_rd][off];
+					}
+				}
+			}
+	
+			if (!is_hit) {
+				sector_type loaded_sector;
+				const auto load_port = get_mem_port(mem_req.load_addr);
+				const auto st_port = ((mem_req.op == READ_WRITE_OP) ?
+						get_mem_port(mem_st_req.write_back_addr) :
+						load_port);
+				// the write-back is sent separately if the
+				// evicted line belongs to another memory port
+				// or if there is nothing to load
+				const auto split_write_back =
+					((mem_req.op == READ_WRITE_OP) &&
+					 (full_write || ((MEM_PORTS > 1) &&
+							 (st_port != load_port))));
+				mem_req_type st_mem_req = {WRITE_OP, 0};
+				if (split_write_back)
+					mem_req.op = READ_OP;
+
+#ifdef __SYNTHESIS__
+				if (split_write_back) {
+					m_mem_req[st_port].write(st_mem_req);
+					m_mem_st_req[st_port].write(mem_st_req);
+				}
+
+				if (!full_write) {
+					// send read request to
+					// memory interface and
+					// write request if
+					// write-back is necessary
+					m_mem_req[load_port].write(mem_req);
+					if (WR_ENABLED)
+						m_mem_st_req[load_port].write(mem_st_req);
+
+					// force FIFO write and
+					// FIFO read to separate
+					// pipeline stages to
+					// avoid deadlock due to
+					// the blocking read
+					ap_wait();
+
+					// read response from
+					// memory interface
+					m_mem_resp[load_port].read(loaded_sector);
+				}
+#else
+				if (split_write_back) {
+					exec_mem_req(m_main_mem[st_port], m_window,
+							m_array_size,
+							st_mem_req,
+							mem_st_req, loaded_sector);
+				}
+
+				if (!full_write) {
+					exec_mem_req(m_main_mem[load_port], m_window,
+							m_array_size,
+							mem_req,
+							mem_st_req, loaded_sector);
+				}
+#endif /* __SYNTHESIS__ */
+
+				if (!full_write) {
+					// merge loaded sector into the line
+					for (size_t off = 0; off < N_WORDS_PER_SECTOR; off++) {
+						line[(sector * N_WORDS_PER_SECTOR) + off] =
+							loaded_sector[off];
+					}
+				}
+
+				if (!tag_hit && allocate) {
+					m_tag[addr.m_addr_line] = addr.m_tag;
+					m_valid[addr.m_addr_line] = true;
+					m_dirty[addr.m_addr_line] = false;
+					if (N_SECTORS > 1)
+						m_valid_sectors[addr.m_addr_line] = 0;
+
+					m_replacer.notify_insertion(addr,
+							(req.hint == INSERT_LRU));
+				}
+
+				if ((N_SECTORS > 1) && allocate)
+					m_valid_sectors[addr.m_addr_line][sector] = true;
+
+				if (read && allocate) {
+					// store loaded line to cache
+					if (RAW_CACHE) {
+						m_raw_cache_core.set_line(
+								m_cache_mem,
+								addr.m_addr_line,
+								line);
+					} else {
+						for (size_t off = 0; off < N_WORDS_PER_LINE; off++)
+							m_cache_mem[addr.m_addr_line][off] = line[off];
+					}
+				}
+			}
+
+			if (!read) {
+				if (allocate) {
+					write_cache<WR_ENABLED>(line, req, addr);
+
+					m_dirty[addr.m_addr_line] = true;
+					m_dirty_set[addr.m_set] = true;
+				} else {
+					write_around<WR_ENABLED>(line, req, addr);
+				}
+			}
+
+#ifndef __SYNTHESIS__
+			lock.unlock();
+			return (is_hit ? HIT : MISS);
+#endif /* __SYNTHESIS__ */
+		}
+
+		void exec_mem_req(mem_type * const main_mem[N_ARRAYS],
+				const window_type &window,
+				const size_t array_size[N_ARRAYS], mem_req_type &req,
+				mem_st_req_type &st_req, sector_type sector) {
+#pragma HLS inline
+			if ((req.op == READ_OP) || (req.op == READ_WRITE_OP)) {
+				// read sector from main memory
+				load_sector(main_mem, window, array_size, req.load_addr,
+						sector);
+			}
+
+			if (WR_ENABLED && ((req.op == WRITE_OP) ||
+						(req.op == READ_WRITE_OP))) {
+				// write line to main memory
+				store_line(main_mem, window, array_size,
+						st_req.write_back_addr,
+						st_req.line, st_req.valid_sectors);
+			}
+		}
+
+		/**
+		 * \brief		Read from main memory the sector
+		 * 			containing \p addr_main, from the array
+		 * 			it belongs to.
+		 *
+		 * \param[in] main_mem	The pointers to the arrays.
+		 * \param[in] window	The window of the arrays covered by
+		 * 			the cache.
+		 * \param[in] array_size	The number of elements of each
+		 * 				array.
+		 * \param[in] addr_main	The address in main memory.
+		 * \param[out] sector	The buffer to store the read sector.
+		 */
+		void load_sector(mem_type * const main_mem[N_ARRAYS],
+				const window_type &window,
+				const size_t array_size[N_ARRAYS],
+				const ap_uint<ADDR_SIZE> addr_main,
+				sector_type sector) {
+#pragma HLS inline
+			const auto array = get_array(addr_main);
+			for (size_t i = 0; i < N_ARRAYS; i++) {
+#pragma HLS unroll
+				if (i == array) {
+					get_sector<AXI_WIDTH>(
+							get_window_mem(main_mem[i], window),
+							get_mem_size(window, array_size[i]),
+							get_array_addr(addr_main),
+							sector);
+				}
+			}
+		}
+
+		/**
+		 * \brief		Write a line to main memory, into
+		 * 			the array it belongs to.
+		 *
+		 * \param[in] main_mem	The pointers to the arrays.
+		 * \param[in] window	The window of the arrays covered by
+		 * 			the cache.
+		 * \param[in] array_size	The number of elements of each
+		 * 				array.
+		 * \param[in] addr_main	The address in main memory.
+		 * \param[in] line	The line to be written.
+		 * \param[in] valid_sectors	The sectors of \p line to be
+		 * 				written.
+		 */
+		void store_line(mem_type * const main_mem[N_ARRAYS],
+				const window_type &window,
+				const size_t array_size[N_ARRAYS],
+				const ap_uint<ADDR_SIZE> addr_main,
+				const line_type line,
+				const sectors_mask_type valid_sectors) {
+#pragma HLS inline
+			const auto array = get_array(addr_main);
+			for (size_t i = 0; i < N_ARRAYS; i++) {
+#pragma HLS unroll
+				if (i == array) {
+					set_line<AXI_WIDTH>(
+							get_window_mem(main_mem[i], window),
+							get_mem_size(window, array_size[i]),
+							get_array_addr(addr_main),
+							line, valid_sectors);
+				}
+			}
+		}
+
+#ifdef __SYNTHESIS__
+		/**
+		 * \brief		Infinite loop managing the cache access
+		 * 			requests (sent from the outside).
+		 *
+		 * \note		The infinite loop must be stopped by
+		 * 			calling \ref stop (from the outside)
+		 * 			when all the accesses have been completed.
+		 */
+		void run_core() {
+#pragma HLS inline off
+			op_type last_op = STOP_OP;
+PHASE_LOOP:		while (1) {
+				if (PRELOAD && (last_op == PRELOAD_OP)) {
+					// write back dirty lines, then load the
+					// requested ones and resume the phase
+					preload_req_type preload_req;
+					m_core_preload.read(preload_req);
+					if (WR_ENABLED)
+						flush();
+					preload_lines(preload_req);
+				} else if (PRELOAD && (last_op == UNLOCK_OP)) {
+					// unlock the requested lines and
+					// resume the phase
+					preload_req_type unlock_req;
+					m_core_preload.read(unlock_req);
+					unlock_lines(unlock_req);
+				} else {
+					// invalidate all cache lines
+					m_valid = 0;
+					m_dirty_set = 0;
+					m_pinned = 0;
+
+					if (!RESIDENT)
+						m_replacer.init();
+					if (RAW_CACHE)
+						m_raw_cache_core.init();
+
+					if (RESIDENT)
+						preload_all();
+				}
+
+CORE_LOOP:			for (size_t port = 0; ; port = ((port + 1) % PORTS)) {
+#pragma HLS pipeline II=1 style=flp
+					if (RAW_CACHE) {
+#pragma HLS dependence variable=m_cache_mem inter RAW distance=3 true
+					}
+					core_req_type req;
+					// get request and
+					// make pipeline flushable (to avoid deadlock)
+					auto is_req = m_core_req[port].read_nb(req);
+					// issued requests of read-only caches come
+					// from their own queue
+					if (!WR_ENABLED && !is_req)
+						is_req = m_core_issue[port].read_nb(req);
+					// prefetch requests have the lowest priority
+					auto is_prefetch = false;
+					if (PREFETCH && !is_req && is_idle())
+						is_prefetch = m_core_prefetch.read_nb(req);
+
+					if (is_req || is_prefetch) {
+						// exit the loop if request is "end-of-request",
+						// "move-window", "preload" or "unlock"
+						if ((req.op == STOP_OP) ||
+								(WINDOWED && (req.op == WINDOW_OP)) ||
+								(PRELOAD && ((req.op == PRELOAD_OP) ||
+									     (req.op == UNLOCK_OP)))) {
+							last_op = req.op;
+							break;
+						}
+
+						line_type line;
+#pragma HLS array_partition variable=line type=complete dim=0
+						// prefetch requests are served as
+						// if they came from port 0
+						exec_core_req<RESIDENT>(req, line,
+								(is_prefetch ? 0 : port));
+
+						// updates with READ_WRITE_OP return
+						// the line as it was before them
+						if (!is_prefetch &&
+								((RD_ENABLED && (req.op == READ_OP)) ||
+								 (ATOMIC && (req.op == READ_WRITE_OP)) ||
+								 (!WR_ENABLED))) {
+							// send the response to the read request
+							sector_type sector;
+#pragma HLS array_partition variable=sector type=complete dim=0
+							extract_sector(line, req.addr, sector);
+							m_core_resp[port].write(sector);
+						}
+					}
+				}
+
+				if (PRELOAD && ((last_op == PRELOAD_OP) ||
+							(last_op == UNLOCK_OP)))
+					continue;
+
+				if (PREFETCH) {
+					// drop the prefetch requests not served yet
+					core_req_type dropped_req;
+DROP_LOOP:				while (m_core_prefetch.read_nb(dropped_req)) {}
+				}
+
+				// synchronize main memory with cache memory
+				if (WR_ENABLED)
+					flush();
+
+				if (!WINDOWED || (last_op == STOP_OP))
+					break;
+
+				// move the window of the memory interfaces
+				// (after the write-backs of the old one)
+				window_type window;
+				m_core_window.read(window);
+				mem_req_type window_req;
+				window_req.op = WINDOW_OP;
+				for (size_t mem_port = 0; mem_port < MEM_PORTS; mem_port++) {
+					m_mem_req[mem_port].write(window_req);
+					m_mem_window[mem_port].write(window);
+				}
+			}
+
+			// stop memory interfaces
+			mem_req_type stop_req;
+			stop_req.op = STOP_OP;
+			for (size_t mem_port = 0; mem_port < MEM_PORTS; mem_port++)
+				m_mem_req[mem_port].write(stop_req);
+		}
+
+
+		/**
+		 * \brief		Start the memory interfaces, from
+		 * 			\p MEM_PORT to the last one.
+		 *
+		 * \param[in] main_mem	The pointers to the main memory.
+		 * \param[in] array_size	The number of elements of each
+		 * 				array.
+		 */
+		template <size_t MEM_PORT>
+		typename std::enable_if<(MEM_PORT < MEM_PORTS), void>::type
+			run_mem_ifs(mem_type * const main_mem[MEM_PORTS * N_ARRAYS],
+					const size_t array_size[N_ARRAYS]) {
+#pragma HLS inline
+				run_mem_if<MEM_PORT>(&(main_mem[MEM_PORT * N_ARRAYS]),
+						array_size);
+				run_mem_ifs<MEM_PORT + 1>(main_mem, array_size);
+			}
+
+		template <size_t MEM_PORT>
+		typename std::enable_if<(MEM_PORT == MEM_PORTS), void>::type
+			run_mem_ifs(mem_type * const main_mem[MEM_PORTS * N_ARRAYS],
+					const size_t array_size[N_ARRAYS]) {
+#pragma HLS inline
+				(void)main_mem;
+				(void)array_size;
+			}
+
+		/**
+		 * \brief		Infinite loop managing main memory
+		 * 			access requests (sent from \ref run_core).
+		 *
+		 * \param[in] main_mem	The pointers to the arrays.
+		 * \param[in] array_size	The number of elements of each
+		 * 				array.
+		 *
+		 * \note		\p main_mem must be associated with
+		 * 			a dedicated AXI port.
+		 *
+		 * \note		The infinite loop is stopped by
+		 * 			\ref run_core when it is in turn stopped
+		 * 			from the outside.
+		 */
+		template <size_t MEM_PORT>
+		void run_mem_if(mem_type * const main_mem[N_ARRAYS],
+				const size_t array_size[N_ARRAYS]) {
+#pragma HLS inline off
+			window_type window = {0, MAIN_SIZE};
+MEM_IF_LOOP:		while (1) {
+#pragma HLS pipeline off
+				mem_req_type req;
+				mem_st_req_type st_req;
+				// get request
+				m_mem_req[MEM_PORT].read(req);
+
+				// exit the loop if request is "end-of-request"
+				if (req.op == STOP_OP)
+					break;
+
+				if (WINDOWED && (req.op == WINDOW_OP)) {
+					// move the window
+					m_mem_window[MEM_PORT].read(window);
+					continue;
+				}
+
+				if ((RESIDENT || PRELOAD) && (req.op == PRELOAD_OP)) {
+					// load the lines of the memory port
+					// (in a single burst with MEM_PORTS = 1)
+					size_t n_lines;
+					m_mem_preload[MEM_PORT].read(n_lines);
+					const size_t first_line =
+						(static_cast<size_t>(req.load_addr) >> OFF_SIZE);
+PRELOAD_LOOP:				for (size_t line = (first_line +
+								((MEM_PORT - first_line) &
+								 (MEM_PORTS - 1)));
+							line < (first_line + n_lines);
+							line += MEM_PORTS) {
+#pragma HLS pipeline II=1
+						for (size_t sector = 0; sector < N_SECTORS; sector++) {
+							sector_type loaded_sector;
+							preload_sector(main_mem, window,
+									array_size,
+									((line * N_WORDS_PER_LINE) +
+									 (sector * N_WORDS_PER_SECTOR)),
+									loaded_sector);
+							m_mem_resp[MEM_PORT].write(loaded_sector);
+						}
+					}
+					continue;
+				}
+
+				if (WR_ENABLED)
+					m_mem_st_req[MEM_PORT].read(st_req);
+
+				if (WR_ENABLED && (req.op == WRITE_OP)) {
+					// write back a burst of adjacent lines
+					// (all belonging to the same array)
+					const auto array = get_array(
+							st_req.write_back_addr);
+					st_req.write_back_addr = get_array_addr(
+							st_req.write_back_addr);
+					for (size_t i = 0; i < N_ARRAYS; i++) {
+#pragma HLS unroll
+						if (i == array) {
+							write_burst<AXI_WIDTH>(
+									get_window_mem(main_mem[i],
+										window),
+									get_mem_size(window,
+										array_size[i]),
+									st_req,
+									MEM_PORT);
+						}
+					}
+					continue;
+				}
+
+				sector_type sector;
+				exec_mem_req(main_mem, window, array_size, req, st_req,
+						sector);
+
+				if ((req.op == READ_OP) ||
+						(req.op == READ_WRITE_OP)) {
+					// send the response to the read request
+					m_mem_resp[MEM_PORT].write(sector);
+				}
+			}
+
+		}
+
+		/**
+		 * \brief		Write a burst of lines with consecutive
+		 * 			addresses to main memory.
+		 *
+		 * \param[in] main_mem	The pointer to the array.
+		 * \param[in] mem_size	The number of words in \p main_mem.
+		 * \param[in] st_req	The first line of the burst, with
+		 * 			the address relative to the array: the
+		 * 			following ones (the next lines of the
+		 * 			memory port, MEM_PORTS lines apart) are
+		 * 			read from \ref m_mem_st_req until the
+		 * 			one marked as last.
+		 * \param[in] mem_port	The memory port of the burst.
+		 */
+		template <size_t AXI_W>
+		typename std::enable_if<((AXI_W == 0) ||
+				((N_WORDS_PER_LINE * WORD_SIZE) >= AXI_W)), void>::type
+			write_burst(mem_type * const main_mem,
+					const size_t mem_size,
+					mem_st_req_type st_req,
+					const size_t mem_port) {
+#pragma HLS inline
+				const auto base_addr = st_req.write_back_addr;
+WRITE_BURST_LOOP:		for (size_t line = 0; ; line++) {
+#pragma HLS pipeline II=1
+					set_line<AXI_W>(main_mem, mem_size,
+							(base_addr + (line * MEM_PORTS *
+								      N_WORDS_PER_LINE)),
+							st_req.line, st_req.valid_sectors);
+
+					if (st_req.last)
+						break;
+
+					m_mem_st_req[mem_port].read(st_req);
+				}
+			}
+
+		/**
+		 * \brief		Write a burst of lines narrower than
+		 * 			an AXI beat to main memory.
+		 *
+		 * \note		Consecutive lines are combined in the
+		 * 			same beat, which is written once full
+		 * 			(or at the end of the burst).
+		 */
+		template <size_t AXI_W>
+		typename std::enable_if<((AXI_W > 0) &&
+				((N_WORDS_PER_LINE * WORD_SIZE) < AXI_W)), void>::type
+			write_burst(mem_type * const main_mem,
+					const size_t mem_size,
+					mem_st_req_type st_req,
+					const size_t mem_port) {
+#pragma HLS inline
+				const auto base_addr = st_req.write_back_addr;
+				beat_type beat;
+				beat_mask_type mask = 0;
+WRITE_BURST_LOOP:		for (size_t line = 0; ; line++) {
+#pragma HLS pipeline II=1
+					const auto line_addr = (base_addr +
+							(line * N_WORDS_PER_LINE));
+					const auto first_slot = (line_addr &
+							(N_WORDS_PER_BEAT - 1));
+
+					for (size_t off = 0; off < N_WORDS_PER_LINE; off++) {
+						pack_word(beat, (first_slot + off),
+								st_req.line[off]);
+						mask[first_slot + off] = (((N_SECTORS == 1) ||
+									st_req.valid_sectors[off / N_WORDS_PER_SECTOR]) &&
+								(!PARTIAL_LINE || ((line_addr + off) < mem_size)));
+					}
+
+					if (st_req.last || ((first_slot +
+							N_WORDS_PER_LINE) == N_WORDS_PER_BEAT)) {
+						store_beat(main_mem,
+								(line_addr >> BEAT_OFF_SIZE),
+								beat, mask);
+						mask = 0;
+					}
+
+					if (st_req.last)
+						break;
+
+					m_mem_st_req[mem_port].read(st_req);
+				}
+			}
+
+		/**
+		 * \brief	Check if there are no pending requests on any port.
+		 *
+		 * \return	true if all the request queues are empty.
+		 */
+		bool is_idle() {
+#pragma HLS inline
+			auto idle = true;
+			for (size_t port = 0; port < PORTS; port++) {
+#pragma HLS unroll
+				idle &= m_core_req[port].empty();
+				if (!WR_ENABLED)
+					idle &= m_core_issue[port].empty();
 			}
 
-#ifdef __SYNTHESIS__
-		void exec_core_req(core_req_type &req, line_type line) {
+			return idle;
+		}
 #else
-		hit_status_type exec_core_req(core_req_type &req, line_type line) {
+		/**
+		 * \brief		Serve a prefetch request: unlike the
+		 * 			core, it is never dropped, so that
+		 * 			C simulation does not depend on timing.
+		 *
+		 * \param[in] addr_main	The address in main memory belonging to
+		 * 			the line to be loaded.
+		 */
+		void exec_prefetch(const ap_uint<ADDR_SIZE> addr_main) {
+			assert(get_array(addr_main) < N_ARRAYS);
+			assert(get_array_addr(addr_main) < get_mem_size(m_window,
+						m_array_size[get_array(addr_main)]));
+
+			core_req_type req;
+			req.op = READ_OP;
+			req.addr = map_layout(addr_main);
+			req.hint = INSERT_MRU;
+
+			line_type dummy;
+			exec_core_req<RESIDENT>(req, dummy, 0);
+		}
 #endif /* __SYNTHESIS__ */
+
+		/**
+		 * \brief		Select the port from which to access
+		 * 			\p addr_main, when it is not specified.
+		 *
+		 * \param[in] addr_main	The address in main memory.
+		 *
+		 * \return		The next port, with ROUND_ROBIN.
+		 * \return		The line index modulo PORTS, with
+		 * 			LINE_INTERLEAVED.
+		 * \return		The set index modulo PORTS, with
+		 * 			SET_INTERLEAVED.
+		 */
+		unsigned int get_port(const ap_uint<ADDR_SIZE> addr_main) {
 #pragma HLS inline
-#ifndef __SYNTHESIS__
-			std::unique_lock<std::mutex> lock(m_core_mutex);
-#endif /* __SYNTHESIS__ */
+			if (PORT_POLICY == LINE_INTERLEAVED)
+				return ((map_layout(addr_main) >> OFF_SIZE) % PORTS);
 
-			// check the request type
-			const auto read = ((RD_ENABLED && (req.op == READ_OP)) ||
-					(!WR_ENABLED));
+			if (PORT_POLICY == SET_INTERLEAVED) {
+				const address_type addr(map_layout(addr_main));
+				return (addr.m_set % PORTS);
+			}
 
-			// extract information from address
-			address_type addr(req.addr);
+			const auto port = m_core_port;
+			m_core_port = ((m_core_port + 1) % PORTS);
 
-			auto way = hit(addr);
-			const auto is_hit = (way != -1);
+			return port;
+		}
 
-			if (!is_hit)
-				way = m_replacer.get_way(addr);
+		/**
+		 * \brief		Check if \p addr causes an HIT or a MISS.
+		 *
+		 * \param[in] addr	The address to be checked.
+		 *
+		 * \return		hitting way on HIT.
+		 * \return		-1 on MISS.
+		 */
+		inline int hit(const address_type &addr) const {
+#pragma HLS inline
+			// in a resident cache the way is given by the tag
+			if (RESIDENT)
+				return static_cast<int>(addr.m_tag);
 
-			addr.set_way(way);
-			m_replacer.notify_use(addr);
+			auto addr_tmp = addr;
+			auto hit_way = -1;
+			for (size_t way = 0; way < N_WAYS; way++) {
+				addr_tmp.set_way(way);
+				if (m_valid[addr_tmp.m_addr_line] &&
+						(addr_tmp.m_tag == m_tag[addr_tmp.m_addr_line])) {
+					hit_way = way;
+				}
+			}
 
-			mem_req_type mem_req;
-			mem_st_req_type mem_st_req;
-			typename address_type::addr_line_type addr_cache_rd = addr.m_addr_line;
-			if (!is_hit) {
-				// read from main memory
-				mem_req.op = READ_OP;
-				mem_req.load_addr = addr.m_addr_main;
+			return hit_way;
+		}
 
-				// check if write back is necessary
-				if (WR_ENABLED && m_valid[addr.m_addr_line] &&
-						m_dirty[addr.m_addr_line]) {
-					// build write-back address
-					address_type write_back_addr(m_tag[addr.m_addr_line],
-							addr.m_set, 0, addr.m_way);
-					addr_cache_rd = write_back_addr.m_addr_line;
-					mem_req.op = READ_WRITE_OP;
-					mem_st_req.write_back_addr = write_back_addr.m_addr_main;
+		/**
+		 * \brief	Write back all valid dirty cache lines to main memory.
+		 *
+		 * \note	Only the sets marked in \ref m_dirty_set are
+		 * 		visited, and dirty lines with consecutive addresses
+		 * 		of the same array are merged in a single write
+		 * 		burst. With MEM_PORTS > 1 a burst is open on each
+		 * 		memory port, made of the lines of that port
+		 * 		(MEM_PORTS lines apart).
+		 */
+		void flush() {
+#pragma HLS inline
+			mem_st_req_type st_req[MEM_PORTS];
+#pragma HLS array_partition variable=st_req type=complete dim=1
+			bool pending[MEM_PORTS];
+#pragma HLS array_partition variable=pending type=complete dim=1
+			for (size_t mem_port = 0; mem_port < MEM_PORTS; mem_port++)
+				pending[mem_port] = false;
+FLUSH_LOOP:		while (m_dirty_set.or_reduce()) {
+#pragma HLS pipeline II=1
+				// select the first set which may contain dirty lines
+				const auto set = utils::find_first<N_SETS>(m_dirty_set);
+
+				ap_uint<N_WAYS> dirty_ways;
+				for (size_t way = 0; way < N_WAYS; way++) {
+					dirty_ways[way] = ((RESIDENT ||
+								m_valid[set * N_WAYS + way]) &&
+							m_dirty[set * N_WAYS + way]);
 				}
-			}
 
-			// mem_req.op is READ_WRITE_OP only in case of write back
-			if (is_hit || (mem_req.op == READ_WRITE_OP)) {
-				// read from cache memory
-				if (RAW_CACHE) {
-					m_raw_cache_core.get_line(m_cache_mem,
-							addr_cache_rd,
-							is_hit ? line : mem_st_req.line);
+				const auto way = utils::find_first<N_WAYS>(dirty_ways);
+				if (way == -1) {
+					// no dirty lines left in the set
+					m_dirty_set[set] = false;
 				} else {
-					if (is_hit) {
-						for (size_t off = 0; off < N_WORDS_PER_LINE; off++)
-							line[off] = m_cache_mem[addr_cache_rd][off];
-					} else {
-						for (size_t off = 0; off < N_WORDS_PER_LINE; off++)
-							mem_st_req.line[off] = m_cache_mem[addr_cache_rd][off];
+					// in a resident cache the tag is the way
+					const address_type addr(
+							(RESIDENT ?
+							 typename address_type::tag_type(way) :
+							 typename address_type::tag_type(
+								 m_tag[set * N_WAYS + way])),
+							set, 0, way);
+					const auto mem_port = get_mem_port(addr.m_addr_main);
+					const auto adjacent = (pending[mem_port] &&
+							(addr.m_addr_main ==
+							 (st_req[mem_port].write_back_addr +
+							  (MEM_PORTS * N_WORDS_PER_LINE))) &&
+							(get_array(addr.m_addr_main) ==
+							 get_array(st_req[mem_port].write_back_addr)));
+
+					if (pending[mem_port]) {
+						// close the burst if the line
+						// cannot be appended to it
+						st_req[mem_port].last = !adjacent;
+						write_back(st_req[mem_port]);
+					}
+
+					if (!adjacent) {
+#ifdef __SYNTHESIS__
+						// open a new write burst
+						mem_req_type req = {WRITE_OP, 0};
+						m_mem_req[mem_port].write(req);
+#endif /* __SYNTHESIS__ */
 					}
+
+					// read line
+					st_req[mem_port].write_back_addr = addr.m_addr_main;
+					for (size_t off = 0; off < N_WORDS_PER_LINE; off++)
+						st_req[mem_port].line[off] = m_cache_mem[addr.m_addr_line][off];
+					st_req[mem_port].valid_sectors =
+						get_valid_sectors(addr.m_addr_line);
+					pending[mem_port] = true;
+
+					m_dirty[addr.m_addr_line] = false;
 				}
 			}
-	
-			if (!is_hit) {
+
+			for (size_t mem_port = 0; mem_port < MEM_PORTS; mem_port++) {
+				if (pending[mem_port]) {
+					st_req[mem_port].last = true;
+					write_back(st_req[mem_port]);
+				}
+			}
+		}
+
+		/**
+		 * \brief	Load all the lines of main memory (or of the
+		 * 		window) to a resident cache.
+		 */
+		void preload_all() {
+#pragma HLS inline
+			const preload_req_type preload_req = {0, N_RESIDENT_LINES, false};
+			preload_lines(preload_req);
+		}
+
+		/**
+		 * \brief		Load a range of lines to the cache.
+		 *
+		 * \param[in] preload_req	The address of the first line,
+		 * 				the number of lines and whether
+		 * 				they must be pinned.
+		 *
+		 * \note		The lines are requested to the memory
+		 * 			interfaces with a single request each,
+		 * 			and are read back in order of address.
+		 * 			Since the cache must not contain dirty
+		 * 			lines, those which are evicted are not
+		 * 			written back.
+		 */
+		void preload_lines(const preload_req_type &preload_req) {
+#pragma HLS inline
 #ifdef __SYNTHESIS__
-				// send read request to
-				// memory interface and
-				// write request if
-				// write-back is necessary
-				m_mem_req.write(mem_req);
-				if (WR_ENABLED)
-					m_mem_st_req.write(mem_st_req);
+			mem_req_type req;
+			req.op = PRELOAD_OP;
+			req.load_addr = preload_req.addr;
+			for (size_t mem_port = 0; mem_port < MEM_PORTS; mem_port++) {
+				m_mem_req[mem_port].write(req);
+				m_mem_preload[mem_port].write(preload_req.n_lines);
+			}
+#endif /* __SYNTHESIS__ */
 
-				// force FIFO write and
-				// FIFO read to separate
-				// pipeline stages to
-				// avoid deadlock due to
-				// the blocking read
-				ap_wait();
+PRELOAD_LOOP:		for (size_t line_id = 0; line_id < preload_req.n_lines;
+					line_id++) {
+#pragma HLS pipeline II=1
+				const ap_uint<ADDR_SIZE> addr_main = (preload_req.addr +
+						(line_id * N_WORDS_PER_LINE));
+				const auto mem_port = get_mem_port(addr_main);
 
-				// read response from
-				// memory interface
-				m_mem_resp.read(line);
+				line_type line;
+				for (size_t sector = 0; sector < N_SECTORS; sector++) {
+#ifdef __SYNTHESIS__
+					m_mem_resp[mem_port].read(
+							&(line[sector * N_WORDS_PER_SECTOR]));
 #else
-				exec_mem_req(m_main_mem, mem_req, mem_st_req, line);
+					preload_sector(m_main_mem[mem_port], m_window,
+							m_array_size,
+							(addr_main +
+							 (sector * N_WORDS_PER_SECTOR)),
+							&(line[sector * N_WORDS_PER_SECTOR]));
 #endif /* __SYNTHESIS__ */
+				}
 
-				m_tag[addr.m_addr_line] = addr.m_tag;
-				m_valid[addr.m_addr_line] = true;
-				m_dirty[addr.m_addr_line] = false;
+				address_type addr(addr_main);
+				auto way = hit(addr);
+				const auto tag_hit = (way != -1);
 
-				m_replacer.notify_insertion(addr);
+				if (!tag_hit)
+					way = m_replacer.get_way(addr, get_pinned_ways(addr));
 
-				if (read) {
-					// store loaded line to cache
-					if (RAW_CACHE) {
-						m_raw_cache_core.set_line(
-								m_cache_mem,
-								addr.m_addr_line,
-								line);
-					} else {
-						for (size_t off = 0; off < N_WORDS_PER_LINE; off++)
-							m_cache_mem[addr.m_addr_line][off] = line[off];
-					}
+				addr.set_way(way);
+				if (!RESIDENT) {
+					m_replacer.notify_use(addr);
+					if (!tag_hit)
+						m_replacer.notify_insertion(addr);
 				}
-			}
 
-			if (!read) {
-				write_cache<WR_ENABLED>(line, req, addr);
+				// store loaded line to cache
+				if (RAW_CACHE) {
+					m_raw_cache_core.set_line(m_cache_mem,
+							addr.m_addr_line, line);
+				} else {
+					for (size_t off = 0; off < N_WORDS_PER_LINE; off++)
+						m_cache_mem[addr.m_addr_line][off] = line[off];
+				}
 
-				m_dirty[addr.m_addr_line] = true;
-			}
+				if (!RESIDENT) {
+					m_tag[addr.m_addr_line] = addr.m_tag;
+					m_valid[addr.m_addr_line] = true;
+					if (N_SECTORS > 1)
+						m_valid_sectors[addr.m_addr_line] = -1;
+				}
+				m_dirty[addr.m_addr_line] = false;
 
-#ifndef __SYNTHESIS__
-			lock.unlock();
-			return (is_hit ? HIT : MISS);
-#endif /* __SYNTHESIS__ */
+				if (PRELOAD && !RESIDENT && preload_req.pin) {
+					// leave at least one way of the set unpinned
+					auto pinned_ways = get_pinned_ways(addr);
+					pinned_ways[addr.m_way] = true;
+					if (!pinned_ways.and_reduce())
+						m_pinned[addr.m_addr_line] = true;
+				}
+			}
 		}
 
-		void exec_mem_req(T * const main_mem, mem_req_type &req,
-				mem_st_req_type &st_req, line_type line) {
+		/**
+		 * \brief		Unlock a range of lines.
+		 *
+		 * \param[in] unlock_req	The address of the first line and
+		 * 				the number of lines.
+		 */
+		void unlock_lines(const preload_req_type &unlock_req) {
 #pragma HLS inline
-			if ((req.op == READ_OP) || (req.op == READ_WRITE_OP)) {
-				// read line from main memory
-				get_line(main_mem, req.load_addr, line);
+UNLOCK_LOOP:		for (size_t line_id = 0; line_id < unlock_req.n_lines;
+					line_id++) {
+#pragma HLS pipeline II=1
+				address_type addr(unlock_req.addr +
+						(line_id * N_WORDS_PER_LINE));
+				const auto way = hit(addr);
+				if (way != -1) {
+					addr.set_way(way);
+					m_pinned[addr.m_addr_line] = false;
+				}
 			}
+		}
 
-			if (WR_ENABLED && ((req.op == WRITE_OP) ||
-						(req.op == READ_WRITE_OP))) {
-				// write line to main memory
-				set_line(main_mem, st_req.write_back_addr,
-						st_req.line);
-			}
+		/**
+		 * \brief		Read a sector to be preloaded.
+		 *
+		 * \param[in] main_mem	The pointers to the arrays.
+		 * \param[in] window	The window of the arrays covered by
+		 * 			the cache.
+		 * \param[in] array_size	The number of elements of each
+		 * 				array.
+		 * \param[in] addr_main	The address in main memory.
+		 * \param[out] sector	The buffer to store the read sector.
+		 *
+		 * \note		Sectors outside the arrays (between
+		 * 			consecutive arrays, or beyond the
+		 * 			window) are not read.
+		 */
+		void preload_sector(mem_type * const main_mem[N_ARRAYS],
+				const window_type &window,
+				const size_t array_size[N_ARRAYS],
+				const ap_uint<ADDR_SIZE> addr_main,
+				sector_type sector) {
+#pragma HLS inline
+			if (get_array_addr(addr_main) < get_mem_size(window,
+						array_size[get_array(addr_main)]))
+				load_sector(main_mem, window, array_size,
+						addr_main, sector);
 		}
 
-#ifdef __SYNTHESIS__
 		/**
-		 * \brief		Infinite loop managing the cache access
-		 * 			requests (sent from the outside).
+		 * \brief		Return the pinned ways of the set of
+		 * 			\p addr.
 		 *
-		 * \note		The infinite loop must be stopped by
-		 * 			calling \ref stop (from the outside)
-		 * 			when all the accesses have been completed.
+		 * \param[in] addr	The address.
+		 *
+		 * \return		One bit for each way, set if the way
+		 * 			is pinned.
 		 */
-		void run_core() {
-#pragma HLS inline off
-			// invalidate all cache lines
-			m_valid = 0;
+		ap_uint<N_WAYS> get_pinned_ways(const address_type &addr) const {
+#pragma HLS inline
+			ap_uint<N_WAYS> pinned_ways = 0;
+			if (PRELOAD) {
+				auto addr_tmp = addr;
+				for (size_t way = 0; way < N_WAYS; way++) {
+					addr_tmp.set_way(way);
+					pinned_ways[way] = m_pinned[addr_tmp.m_addr_line];
+				}
+			}
 
-			m_replacer.init();
-			if (RAW_CACHE)
-				m_raw_cache_core.init();
+			return pinned_ways;
+		}
 
-CORE_LOOP:		for (size_t port = 0; ; port = ((port + 1) % PORTS)) {
-#pragma HLS pipeline II=1 style=flp
-				if (RAW_CACHE) {
-#pragma HLS dependence variable=m_cache_mem inter RAW distance=3 true
-				}
-				core_req_type req;
-				// get request and
-				// make pipeline flushable (to avoid deadlock)
-				if (m_core_req[port].read_nb(req)) {
-					// exit the loop if request is "end-of-request"
-					if (req.op == STOP_OP)
-						break;
+		/**
+		 * \brief		Send a line to be written back to the
+		 * 			memory interface.
+		 *
+		 * \param[in] st_req	The line to be written back.
+		 */
+		void write_back(const mem_st_req_type &st_req) {
+#pragma HLS inline
+			const auto mem_port = get_mem_port(st_req.write_back_addr);
+#ifdef __SYNTHESIS__
+			m_mem_st_req[mem_port].write(st_req);
+#else
+			store_line(m_main_mem[mem_port], m_window, m_array_size,
+					st_req.write_back_addr, st_req.line,
+					st_req.valid_sectors);
+#endif /* __SYNTHESIS__ */
+		}
 
-					line_type line;
-#pragma HLS array_partition variable=line type=complete dim=0
-					exec_core_req(req, line);
+		/**
+		 * \brief		Return the memory port in charge of the
+		 * 			line containing \p addr_main.
+		 *
+		 * \param[in] addr_main	The address in main memory.
+		 *
+		 * \return		The line index modulo MEM_PORTS.
+		 */
+		unsigned int get_mem_port(const ap_uint<ADDR_SIZE> addr_main) const {
+#pragma HLS inline
+			if (MEM_PORTS == 1)
+				return 0;
 
-					if ((RD_ENABLED && (req.op == READ_OP)) ||
-							(!WR_ENABLED)) {
-						// send the response to the read request
-						m_core_resp[port].write(line);
-					}
-				}
-			}
+			return ((addr_main >> OFF_SIZE) & (MEM_PORTS - 1));
+		}
 
-			// synchronize main memory with cache memory
-			if (WR_ENABLED)
-				flush();
+		/**
+		 * \brief		Return the pointer to the beginning of
+		 * 			\p window in \p main_mem.
+		 *
+		 * \param[in] main_mem	The pointer to the array.
+		 * \param[in] window	The window of the array.
+		 *
+		 * \return		\p main_mem itself, if not WINDOWED.
+		 */
+		static mem_type *get_window_mem(mem_type * const main_mem,
+				const window_type &window) {
+#pragma HLS inline
+			if (!WINDOWED)
+				return main_mem;
 
-			// stop memory interface
-			mem_req_type stop_req;
-			stop_req.op = STOP_OP;
-			m_mem_req.write(stop_req);
+			return (main_mem + (window.base >> BEAT_OFF_SIZE));
 		}
 
 		/**
-		 * \brief		Infinite loop managing main memory
-		 * 			access requests (sent from \ref run_core).
+		 * \brief		Return the number of words of an array
+		 * 			which can be accessed.
 		 *
-		 * \param[in] main_mem	The pointer to the main memory.
+		 * \param[in] window	The window of the array.
+		 * \param[in] array_size	The number of elements of the
+		 * 				array.
 		 *
-		 * \note		\p main_mem must be associated with
-		 * 			a dedicated AXI port.
+		 * \return		The smallest of the window length and
+		 * 			\p array_size.
+		 */
+		static size_t get_mem_size(const window_type &window,
+				const size_t array_size) {
+#pragma HLS inline
+			return ((array_size < window.length) ?
+					array_size : window.length);
+		}
+
+		/**
+		 * \brief		Return the array to which \p addr_main
+		 * 			belongs.
 		 *
-		 * \note		The infinite loop is stopped by
-		 * 			\ref run_core when it is in turn stopped
-		 * 			from the outside.
+		 * \param[in] addr_main	The address in main memory.
+		 *
+		 * \return		The array identifier.
 		 */
-		void run_mem_if(T * const main_mem) {
-#pragma HLS inline off
-MEM_IF_LOOP:		while (1) {
-#pragma HLS pipeline off
-				mem_req_type req;
-				mem_st_req_type st_req;
-				// get request
-				m_mem_req.read(req);
+		unsigned int get_array(const ap_uint<ADDR_SIZE> addr_main) const {
+#pragma HLS inline
+			if (N_ARRAYS == 1)
+				return 0;
 
-				// exit the loop if request is "end-of-request"
-				if (req.op == STOP_OP)
-					break;
+			return (addr_main >> ARRAY_ADDR_SIZE);
+		}
 
-				if (WR_ENABLED)
-					m_mem_st_req.read(st_req);
+		/**
+		 * \brief		Return the address of \p addr_main
+		 * 			relative to the array it belongs to.
+		 *
+		 * \param[in] addr_main	The address in main memory.
+		 *
+		 * \return		The address without the array identifier.
+		 */
+		ap_uint<ADDR_SIZE> get_array_addr(
+				const ap_uint<ADDR_SIZE> addr_main) const {
+#pragma HLS inline
+			const ap_uint<ADDR_SIZE> shifted = (addr_main << ARRAY_ID_SIZE);
 
-				line_type line;
-				exec_mem_req(main_mem, req, st_req, line);
+			return (shifted >> ARRAY_ID_SIZE);
+		}
+
+		/**
+		 * \brief		Return the mask of the loaded sectors
+		 * 			of a cache line.
+		 *
+		 * \param[in] addr_line	The cache line address.
+		 *
+		 * \return		The mask of the loaded sectors.
+		 */
+		sectors_mask_type get_valid_sectors(
+				const typename address_type::addr_line_type addr_line) const {
+#pragma HLS inline
+			// resident lines are always complete
+			if (RESIDENT)
+				return -1;
 
-				if ((req.op == READ_OP) ||
-						(req.op == READ_WRITE_OP)) {
-					// send the response to the read request
-					m_mem_resp.write(line);
-				}
-			}
+			if (N_SECTORS > 1)
+				return m_valid_sectors[addr_line];
 
+			return 1;
 		}
-#endif /* __SYNTHESIS__ */
 
 		/**
-		 * \brief		Check if \p addr causes an HIT or a MISS.
+		 * \brief		Map \p addr_main with \p LINE_LAYOUT
+		 * 			onto the address used inside the cache
+		 * 			(and by the L1 cache).
 		 *
-		 * \param[in] addr	The address to be checked.
+		 * \param[in] addr_main	The address in main memory.
 		 *
-		 * \return		hitting way on HIT.
-		 * \return		-1 on MISS.
+		 * \return		The address whose tag, set index and
+		 * 			offset select the line holding
+		 * 			\p addr_main and its position in it.
 		 */
-		inline int hit(const address_type &addr) const {
+		static ap_uint<ADDR_SIZE> map_layout(
+				const ap_uint<ADDR_SIZE> addr_main) {
 #pragma HLS inline
-			auto addr_tmp = addr;
-			auto hit_way = -1;
-			for (size_t way = 0; way < N_WAYS; way++) {
-				addr_tmp.set_way(way);
-				if (m_valid[addr_tmp.m_addr_line] &&
-						(addr_tmp.m_tag == m_tag[addr_tmp.m_addr_line])) {
-					hit_way = way;
-				}
-			}
+			return LINE_LAYOUT::template map<ADDR_SIZE, N_WORDS_PER_LINE>(
+					addr_main);
+		}
 
-			return hit_way;
+		/**
+		 * \brief		Rebuild the address in main memory from
+		 * 			the address used inside the cache.
+		 *
+		 * \param[in] addr	The address used inside the cache.
+		 *
+		 * \return		The address in main memory.
+		 */
+		static ap_uint<ADDR_SIZE> unmap_layout(const ap_uint<ADDR_SIZE> addr) {
+#pragma HLS inline
+			return LINE_LAYOUT::template unmap<ADDR_SIZE, N_WORDS_PER_LINE>(
+					addr);
 		}
 
 		/**
-		 * \brief	Write back all valid dirty cache lines to main memory.
+		 * \brief		Extract from \p line the sector containing
+		 * 			\p addr_main.
+		 *
+		 * \param[in] line	The cache line.
+		 * \param[in] addr_main	The address in main memory belonging to
+		 * 			the sector.
+		 * \param[out] sector	The buffer to store the sector.
 		 */
-		void flush() {
+		void extract_sector(const line_type line,
+				const ap_uint<ADDR_SIZE> addr_main,
+				sector_type sector) const {
 #pragma HLS inline
-			for (size_t set = 0; set < N_SETS; set++) {
-				for (size_t way = 0; way < N_WAYS; way++) {
-					const address_type addr(
-							m_tag[set * N_WAYS + way],
-							set, 0, way);
-					// check if line has to be written back
-					if (m_valid[addr.m_addr_line] &&
-							m_dirty[addr.m_addr_line]) {
-						// write line back
-						line_type line;
+			const address_type addr(addr_main);
+			const auto first = ((addr.m_off >> SECTOR_OFF_SIZE) *
+					N_WORDS_PER_SECTOR);
 
-						// read line
-						for (size_t off = 0; off < N_WORDS_PER_LINE; off++)
-							line[off] = m_cache_mem[addr.m_addr_line][off];
+			for (size_t off = 0; off < N_WORDS_PER_SECTOR; off++)
+				sector[off] = line[first + off];
+		}
 
-						mem_req_type req = {
-							WRITE_OP, 0};
-						mem_st_req_type st_req;
-						st_req.write_back_addr = addr.m_addr_main;
-						for (size_t off = 0; off < N_WORDS_PER_LINE; off++)
-							st_req.line[off] = line[off];
-#ifdef __SYNTHESIS__
-						// send write request to memory
-						// interface
-						m_mem_req.write(req);
-						m_mem_st_req.write(st_req);
-#else
-						line_type dummy;
-						exec_mem_req(m_main_mem,
-								req, st_req,
-								dummy);
-#endif /* __SYNTHESIS__ */
+		template <size_t AXI_W>
+		typename std::enable_if<(AXI_W == 0), void>::type
+			get_sector(const mem_type * const mem, const size_t mem_size,
+					const ap_uint<(ADDR_SIZE > 0) ? ADDR_SIZE : 1> addr,
+					sector_type sector) {
+#pragma HLS inline
+				const ap_uint<(ADDR_SIZE > 0) ? ADDR_SIZE : 1> first =
+					((addr >> SECTOR_OFF_SIZE) << SECTOR_OFF_SIZE);
+
+				for (size_t off = 0; off < N_WORDS_PER_SECTOR; off++) {
+#pragma HLS unroll
+					// skip words beyond the end of main memory
+					if (!PARTIAL_LINE || ((first + off) < mem_size))
+						sector[off] = mem[unmap_layout(first + off)];
+				}
+			}
 
-						m_dirty[addr.m_addr_line] = false;
+		template <size_t AXI_W>
+		typename std::enable_if<(AXI_W > 0), void>::type
+			get_sector(const mem_type * const mem, const size_t mem_size,
+					const ap_uint<(ADDR_SIZE > 0) ? ADDR_SIZE : 1> addr,
+					sector_type sector) {
+#pragma HLS inline
+				const ap_uint<(ADDR_SIZE > 0) ? ADDR_SIZE : 1> first =
+					((addr >> SECTOR_OFF_SIZE) << SECTOR_OFF_SIZE);
+				if (N_WORDS_PER_SECTOR >= N_WORDS_PER_BEAT) {
+GET_SECTOR_LOOP:			for (size_t beat = 0; beat < N_BEATS_PER_SECTOR; beat++) {
+#pragma HLS pipeline II=1
+						// skip beats beyond the end of main memory
+						if (PARTIAL_LINE && ((((first >> BEAT_OFF_SIZE) +
+											beat) << BEAT_OFF_SIZE) >=
+									mem_size))
+							break;
+
+						// with tiled lines, each tile row is
+						// a separate run of consecutive beats
+						const beat_type data = mem[unmap_layout(first +
+								(beat * N_WORDS_PER_BEAT)) >>
+							BEAT_OFF_SIZE];
+						for (size_t slot = 0; slot < N_WORDS_PER_BEAT; slot++) {
+							sector[(beat * N_WORDS_PER_BEAT) + slot] =
+								unpack_word(data, slot);
+						}
 					}
+				} else {
+					// the sector is a slice of a single beat
+					const beat_type data = mem[first >> BEAT_OFF_SIZE];
+					const auto first_slot = (first & (N_WORDS_PER_BEAT - 1));
+					for (size_t off = 0; off < N_WORDS_PER_SECTOR; off++)
+						sector[off] = unpack_word(data, (first_slot + off));
 				}
 			}
-		}
 
-		void get_line(const T * const mem,
-				const ap_uint<(ADDR_SIZE > 0) ? ADDR_SIZE : 1> addr,
-				line_type line) {
+		template <size_t AXI_W>
+		typename std::enable_if<(AXI_W == 0), void>::type
+			set_line(mem_type * const mem, const size_t mem_size,
+					const ap_uint<(ADDR_SIZE > 0) ? ADDR_SIZE : 1> addr,
+					const line_type line,
+					const sectors_mask_type valid_sectors) {
 #pragma HLS inline
-			const T * const mem_line = &(mem[addr & (-1U << OFF_SIZE)]);
+				const ap_uint<(ADDR_SIZE > 0) ? ADDR_SIZE : 1> first =
+					((addr >> OFF_SIZE) << OFF_SIZE);
 
-			for (size_t off = 0; off < N_WORDS_PER_LINE; off++) {
+				for (size_t off = 0; off < N_WORDS_PER_LINE; off++) {
 #pragma HLS unroll
-				line[off] = mem_line[off];
+					// skip sectors which have never been loaded
+					// and words beyond the end of main memory
+					if (((N_SECTORS == 1) ||
+								valid_sectors[off / N_WORDS_PER_SECTOR]) &&
+							(!PARTIAL_LINE || ((first + off) < mem_size)))
+						mem[unmap_layout(first + off)] = line[off];
+				}
 			}
-		}
 
-		void set_line(T * const mem,
-				const ap_uint<(ADDR_SIZE > 0) ? ADDR_SIZE : 1> addr,
-				const line_type line) {
+		template <size_t AXI_W>
+		typename std::enable_if<(AXI_W > 0), void>::type
+			set_line(mem_type * const mem, const size_t mem_size,
+					const ap_uint<(ADDR_SIZE > 0) ? ADDR_SIZE : 1> addr,
+					const line_type line,
+					const sectors_mask_type valid_sectors) {
 #pragma HLS inline
-			T * const mem_line = &(mem[addr & (-1U << OFF_SIZE)]);
+				const ap_uint<(ADDR_SIZE > 0) ? ADDR_SIZE : 1> first =
+					((addr >> OFF_SIZE) << OFF_SIZE);
+
+				if (N_WORDS_PER_LINE >= N_WORDS_PER_BEAT) {
+SET_LINE_LOOP:				for (size_t beat = 0; beat < N_BEATS_PER_LINE; beat++) {
+#pragma HLS pipeline II=1
+						beat_type data;
+						beat_mask_type mask;
+						for (size_t slot = 0; slot < N_WORDS_PER_BEAT; slot++) {
+							const auto off = ((beat * N_WORDS_PER_BEAT) + slot);
+							pack_word(data, slot, line[off]);
+							// skip sectors which have never been loaded
+							// and words beyond the end of main memory
+							mask[slot] = (((N_SECTORS == 1) ||
+										valid_sectors[off / N_WORDS_PER_SECTOR]) &&
+									(!PARTIAL_LINE || ((first + off) < mem_size)));
+						}
+						store_beat(mem, (unmap_layout(first +
+										(beat * N_WORDS_PER_BEAT)) >>
+									BEAT_OFF_SIZE), data, mask);
+					}
+				} else {
+					// the line is a slice of a single beat
+					beat_type data;
+					beat_mask_type mask = 0;
+					const auto first_slot = (first & (N_WORDS_PER_BEAT - 1));
+					for (size_t off = 0; off < N_WORDS_PER_LINE; off++) {
+						pack_word(data, (first_slot + off), line[off]);
+						mask[first_slot + off] = (((N_SECTORS == 1) ||
+									valid_sectors[off / N_WORDS_PER_SECTOR]) &&
+								(!PARTIAL_LINE || ((first + off) < mem_size)));
+					}
+					store_beat(mem, (first >> BEAT_OFF_SIZE), data, mask);
+				}
+			}
 
-			for (size_t off = 0; off < N_WORDS_PER_LINE; off++) {
-#pragma HLS unroll
-				mem_line[off] = line[off];
+		/**
+		 * \brief		Write a beat to main memory.
+		 *
+		 * \param[in] mem	The pointer to the main memory.
+		 * \param[in] beat_addr	The beat address.
+		 * \param[in] data	The beat to be written.
+		 * \param[in] mask	The words of \p data to be written:
+		 * 			the other ones are preserved by
+		 * 			reading the beat first (the beat is
+		 * 			not accessed at all if \p mask is 0).
+		 */
+		void store_beat(mem_type * const mem,
+				const ap_uint<(ADDR_SIZE > 0) ? ADDR_SIZE : 1> beat_addr,
+				beat_type data, const beat_mask_type mask) {
+#pragma HLS inline
+			if (!mask.or_reduce())
+				return;
+
+			if (!mask.and_reduce()) {
+				const beat_type old_data = mem[beat_addr];
+				for (size_t slot = 0; slot < N_WORDS_PER_BEAT; slot++) {
+					if (!mask[slot]) {
+						data.range(((slot + 1) * WORD_SIZE) - 1,
+								(slot * WORD_SIZE)) =
+							old_data.range(((slot + 1) * WORD_SIZE) - 1,
+									(slot * WORD_SIZE));
+					}
+				}
 			}
+
+			mem[beat_addr] = data;
+		}
+
+		static void pack_word(beat_type &data, const size_t slot,
+				const T word) {
+#pragma HLS inline
+			union {
+				T word;
+				typename utils::raw_word<sizeof(T)>::type raw;
+			} conv;
+			conv.word = word;
+
+			data.range(((slot + 1) * WORD_SIZE) - 1, (slot * WORD_SIZE)) =
+				ap_uint<WORD_SIZE>(conv.raw);
+		}
+
+		static T unpack_word(const beat_type &data, const size_t slot) {
+#pragma HLS inline
+			union {
+				T word;
+				typename utils::raw_word<sizeof(T)>::type raw;
+			} conv;
+			conv.raw = data.range(((slot + 1) * WORD_SIZE) - 1,
+					(slot * WORD_SIZE)).to_uint64();
+
+			return conv.word;
 		}
 
 #ifndef __SYNTHESIS__
@@ -776,19 +3294,38 @@ MEM_IF_LOOP:		while (1) {
 			}
 		}
 
+		bool is_pending(const unsigned int port) {
+			std::lock_guard<std::mutex> lock(m_pending_mutex);
+			return !m_pending[port].empty();
+		}
+
 #endif /* __SYNTHESIS__ */
 
 		class square_bracket_proxy {
 			private:
 				cache *m_cache;
 				const ap_uint<ADDR_SIZE> m_addr_main;
+				const access_hint_type m_hint;
 			public:
 				square_bracket_proxy(cache *c,
-						const ap_uint<ADDR_SIZE> addr_main):
-					m_cache(c), m_addr_main(addr_main) {
+						const ap_uint<ADDR_SIZE> addr_main,
+						const access_hint_type hint = INSERT_MRU):
+					m_cache(c), m_addr_main(addr_main),
+					m_hint(hint) {
 #pragma HLS inline
 					}
 
+				/**
+				 * \brief	Return a proxy to the same data
+				 * 		element, accessed with \p hint.
+				 */
+				square_bracket_proxy hint(
+						const access_hint_type hint) const {
+#pragma HLS inline
+					return square_bracket_proxy(m_cache,
+							m_addr_main, hint);
+				}
+
 				operator T() const {
 #pragma HLS inline
 					return get();
@@ -807,15 +3344,50 @@ MEM_IF_LOOP:		while (1) {
 					return *this;
 				}
 
+				square_bracket_proxy &operator+=(const T operand) {
+#pragma HLS inline
+					update(UPDATE_ADD, operand);
+					return *this;
+				}
+
+				square_bracket_proxy &operator-=(const T operand) {
+#pragma HLS inline
+					update(UPDATE_SUB, operand);
+					return *this;
+				}
+
+				square_bracket_proxy &operator&=(const T operand) {
+#pragma HLS inline
+					update(UPDATE_AND, operand);
+					return *this;
+				}
+
+				square_bracket_proxy &operator|=(const T operand) {
+#pragma HLS inline
+					update(UPDATE_OR, operand);
+					return *this;
+				}
+
+				square_bracket_proxy &operator^=(const T operand) {
+#pragma HLS inline
+					update(UPDATE_XOR, operand);
+					return *this;
+				}
+
 			private:
 				T get() const {
 #pragma HLS inline
-					return m_cache->get(m_addr_main);
+					return m_cache->get(m_addr_main, m_hint);
 				}
 
 				void set(const T data) {
 #pragma HLS inline
-					m_cache->set(m_addr_main, data);
+					m_cache->set(m_addr_main, data, m_hint);
+				}
+
+				void update(const update_op_type op, const T operand) {
+#pragma HLS inline
+					m_cache->update(m_addr_main, op, operand, m_hint);
 				}
 		};
 
@@ -833,12 +3405,362 @@ template <typename T, bool RD_ENABLED, bool WR_ENABLED, size_t PORTS,
 	 size_t MAIN_SIZE, size_t N_SETS, size_t N_WAYS, size_t N_WORDS_PER_LINE,
 	 bool LRU, size_t N_L1_SETS, size_t N_L1_WAYS, bool SWAP_TAG_SET,
 	 size_t LATENCY, storage_impl_type L2_STORAGE_IMPL,
-	 storage_impl_type L1_STORAGE_IMPL>
+	 storage_impl_type L1_STORAGE_IMPL, size_t N_SECTORS, size_t AXI_WIDTH,
+	 size_t MEM_PORTS, size_t N_ARRAYS, typename SET_HASH, bool WINDOWED,
+	 bool PRELOAD, bool PREFETCH, typename WAY_PARTITION,
+	 port_policy_type PORT_POLICY, bool LINE_WRITES, bool ATOMIC,
+	 typename CUSTOM_UPDATE, typename LINE_LAYOUT>
 	 struct is_cache<cache<T, RD_ENABLED, WR_ENABLED, PORTS, MAIN_SIZE,
 	 N_SETS, N_WAYS, N_WORDS_PER_LINE, LRU, N_L1_SETS, N_L1_WAYS,
-	 SWAP_TAG_SET, LATENCY, L2_STORAGE_IMPL, L1_STORAGE_IMPL>&> :
+	 SWAP_TAG_SET, LATENCY, L2_STORAGE_IMPL, L1_STORAGE_IMPL, N_SECTORS,
+	 AXI_WIDTH, MEM_PORTS, N_ARRAYS, SET_HASH, WINDOWED, PRELOAD,
+	 PREFETCH, WAY_PARTITION, PORT_POLICY, LINE_WRITES, ATOMIC,
+	 CUSTOM_UPDATE, LINE_LAYOUT>&> :
+	 std::true_type {};
+
+/**
+ * \brief	View of one of the arrays sharing a cache (N_ARRAYS > 1).
+ *
+ *		It exposes the access interface of the cache, with addresses
+ *		relative to the array \p ARRAY.
+ *
+ * \note	The view of array 0 initializes and stops the shared cache,
+ *		so it must be passed to \ref cache_wrapper (views of the other
+ *		arrays are ignored by \ref init and \ref stop).
+ */
+template <typename CACHE_TYPE, size_t ARRAY>
+class cache_view {
+	template <typename, size_t> friend class cache_view;
+
+	private:
+		typedef typename CACHE_TYPE::data_type data_type;
+		typedef ap_uint<CACHE_TYPE::ADDR_SIZE> addr_main_type;
+
+		CACHE_TYPE *m_cache;
+
+		static addr_main_type to_addr_main(const addr_main_type addr) {
+#pragma HLS inline
+			return ((addr_main_type(ARRAY) << CACHE_TYPE::ARRAY_ADDR_SIZE) |
+					addr);
+		}
+
+	public:
+		cache_view(CACHE_TYPE &c): m_cache(&c) {
+#pragma HLS inline
+		}
+
+		void init() {
+#pragma HLS inline
+			m_cache->init();
+		}
+
+		void stop() {
+#pragma HLS inline
+			m_cache->stop();
+		}
+
+		void preload(const addr_main_type begin, const size_t len,
+				const bool pin = false) {
+#pragma HLS inline
+			m_cache->preload(to_addr_main(begin), len, pin);
+		}
+
+		void lock(const addr_main_type begin, const size_t len) {
+#pragma HLS inline
+			m_cache->lock(to_addr_main(begin), len);
+		}
+
+		void unlock(const addr_main_type begin, const size_t len) {
+#pragma HLS inline
+			m_cache->unlock(to_addr_main(begin), len);
+		}
+
+		void prefetch(const addr_main_type addr_main) {
+#pragma HLS inline
+			m_cache->prefetch(to_addr_main(addr_main));
+		}
+
+		void prefetch_range(const addr_main_type addr_main,
+				const size_t len) {
+#pragma HLS inline
+			m_cache->prefetch_range(to_addr_main(addr_main), len);
+		}
+
+		void get_line(const addr_main_type addr_main,
+				const unsigned int port,
+				typename CACHE_TYPE::line_type line,
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			m_cache->get_line(to_addr_main(addr_main), port, line, hint);
+		}
+
+		template <size_t K>
+		void get_span(const addr_main_type addr_main,
+				const unsigned int port, data_type span[K],
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			m_cache->template get_span<K>(to_addr_main(addr_main), port,
+					span, hint);
+		}
+
+		template <size_t K>
+		void gather(const addr_main_type addrs[K],
+				const unsigned int port, data_type data[K],
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			addr_main_type view_addrs[K];
+#pragma HLS array_partition variable=view_addrs type=complete dim=0
+			for (size_t i = 0; i < K; i++)
+				view_addrs[i] = to_addr_main(addrs[i]);
+
+			m_cache->template gather<K>(view_addrs, port, data, hint);
+		}
+
+		template <size_t K>
+		void get_strided(const addr_main_type addr_main,
+				const size_t stride, const unsigned int port,
+				data_type data[K],
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			m_cache->template get_strided<K>(to_addr_main(addr_main),
+					stride, port, data, hint);
+		}
+
+		data_type get(const addr_main_type addr_main,
+				const unsigned int port,
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			return m_cache->get(to_addr_main(addr_main), port, hint);
+		}
+
+		data_type get(const addr_main_type addr_main,
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			return m_cache->get(to_addr_main(addr_main), hint);
+		}
+
+		void issue_get(const addr_main_type addr_main,
+				const unsigned int port,
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			m_cache->issue_get(to_addr_main(addr_main), port, hint);
+		}
+
+		data_type collect(const unsigned int port) {
+#pragma HLS inline
+			return m_cache->collect(port);
+		}
+
+		void set(const addr_main_type addr_main, const data_type data,
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			m_cache->set(to_addr_main(addr_main), data, hint);
+		}
+
+		void update(const addr_main_type addr_main,
+				const update_op_type op, const data_type operand,
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			m_cache->update(to_addr_main(addr_main), op, operand, hint);
+		}
+
+		data_type fetch_update(const addr_main_type addr_main,
+				const update_op_type op, const data_type operand,
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			return m_cache->fetch_update(to_addr_main(addr_main), op,
+					operand, hint);
+		}
+
+		void fill(const addr_main_type addr_main, const size_t len,
+				const data_type value) {
+#pragma HLS inline
+			m_cache->fill(to_addr_main(addr_main), len, value);
+		}
+
+		template <size_t DST_ARRAY>
+		void copy(cache_view<CACHE_TYPE, DST_ARRAY> &dst,
+				const addr_main_type addr_main, const size_t len) {
+#pragma HLS inline
+			m_cache->copy_lines(*(dst.m_cache),
+					dst.to_addr_main(addr_main),
+					to_addr_main(addr_main), len);
+		}
+
+		template <update_op_type OP>
+		data_type reduce(const addr_main_type addr_main, const size_t len) {
+#pragma HLS inline
+			return m_cache->template reduce<OP>(to_addr_main(addr_main),
+					len);
+		}
+
+		void set_line(const addr_main_type addr_main,
+				const typename CACHE_TYPE::line_type line,
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			m_cache->set_line(to_addr_main(addr_main), line, hint);
+		}
+
+		void set_line_masked(const addr_main_type addr_main,
+				const typename CACHE_TYPE::line_type line,
+				const typename CACHE_TYPE::line_words_mask_type mask,
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			m_cache->set_line_masked(to_addr_main(addr_main), line,
+					mask, hint);
+		}
+
+		typename CACHE_TYPE::square_bracket_proxy operator[](
+				const addr_main_type addr_main) {
+#pragma HLS inline
+			return (*m_cache)[to_addr_main(addr_main)];
+		}
+};
+
+template <typename CACHE_TYPE>
+struct is_cache<cache_view<CACHE_TYPE, 0>&> : std::true_type {};
+
+template<typename>
+struct is_read_write_cache : std::false_type {};
+
+template <typename T, size_t PORTS, size_t MAIN_SIZE, size_t N_SETS,
+	 size_t N_WAYS, size_t N_WORDS_PER_LINE, bool LRU, size_t N_L1_SETS,
+	 size_t N_L1_WAYS, bool SWAP_TAG_SET, size_t LATENCY,
+	 storage_impl_type L2_STORAGE_IMPL, storage_impl_type L1_STORAGE_IMPL,
+	 size_t N_SECTORS, size_t AXI_WIDTH, size_t MEM_PORTS, size_t N_ARRAYS,
+	 typename SET_HASH, bool WINDOWED, bool PRELOAD, bool PREFETCH,
+	 typename WAY_PARTITION, port_policy_type PORT_POLICY,
+	 bool LINE_WRITES, bool ATOMIC, typename CUSTOM_UPDATE,
+	 typename LINE_LAYOUT>
+	 struct is_read_write_cache<cache<T, true, true, PORTS, MAIN_SIZE,
+	 N_SETS, N_WAYS, N_WORDS_PER_LINE, LRU, N_L1_SETS, N_L1_WAYS,
+	 SWAP_TAG_SET, LATENCY, L2_STORAGE_IMPL, L1_STORAGE_IMPL, N_SECTORS,
+	 AXI_WIDTH, MEM_PORTS, N_ARRAYS, SET_HASH, WINDOWED, PRELOAD,
+	 PREFETCH, WAY_PARTITION, PORT_POLICY, LINE_WRITES, ATOMIC,
+	 CUSTOM_UPDATE, LINE_LAYOUT>&> :
 	 std::true_type {};
 
+template <typename CACHE_TYPE, size_t ARRAY>
+struct is_read_write_cache<cache_view<CACHE_TYPE, ARRAY>&> :
+	is_read_write_cache<CACHE_TYPE&> {};
+
+/**
+ * \brief	2-D view of the array cached by a cache, stored by rows of
+ *		\p PITCH elements.
+ *
+ *		Elements are addressed by column \p x and row \p y, and
+ *		windows of elements are read with a request per row.
+ *
+ * \note	The view does not own the cache: the cache must still be
+ *		passed to \ref cache_wrapper.
+ */
+template <typename CACHE_TYPE, size_t PITCH>
+class cache_2d {
+	private:
+		typedef typename CACHE_TYPE::data_type data_type;
+		typedef ap_uint<CACHE_TYPE::ADDR_SIZE> addr_main_type;
+		// signed coordinates spanning the whole array
+		typedef ap_int<(CACHE_TYPE::ADDR_SIZE + 1)> coord_type;
+
+		static const size_t N_ROWS = (CACHE_TYPE::ARRAY_SIZE / PITCH);
+
+		static_assert(CACHE_TYPE::FIXED_ARRAY,
+				"2-D views require N_ARRAYS to be 1 and WINDOWED to be false");
+		static_assert(((PITCH > 0) && (PITCH <= CACHE_TYPE::ARRAY_SIZE)),
+				"PITCH must be greater than 0 and not greater than the array size");
+
+		CACHE_TYPE *m_cache;
+
+		static addr_main_type to_addr_main(const addr_main_type x,
+				const addr_main_type y) {
+#pragma HLS inline
+			return ((y * PITCH) + x);
+		}
+
+	public:
+		cache_2d(CACHE_TYPE &c): m_cache(&c) {
+#pragma HLS inline
+		}
+
+		data_type get(const addr_main_type x, const addr_main_type y,
+				const unsigned int port,
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			return m_cache->get(to_addr_main(x, y), port, hint);
+		}
+
+		data_type get(const addr_main_type x, const addr_main_type y,
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			return m_cache->get(to_addr_main(x, y), hint);
+		}
+
+		void set(const addr_main_type x, const addr_main_type y,
+				const data_type data,
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			m_cache->set(to_addr_main(x, y), data, hint);
+		}
+
+		/**
+		 * \brief		Read the window of \p R rows and \p C
+		 * 			columns whose top-left element is at
+		 * 			column \p x and row \p y.
+		 *
+		 * \param[in] x		The column of the top-left element
+		 * 			(possibly negative).
+		 * \param[in] y		The row of the top-left element
+		 * 			(possibly negative).
+		 * \param[out] window	The buffer to store the window.
+		 * \param[in] hint	The access hint.
+		 *
+		 * \note		Elements outside the array read as
+		 * 			zero. Each row is read with
+		 * 			\ref cache::get_span from port
+		 * 			row % PORTS, so that, with an L1 cache
+		 * 			of at least R lines per port, sliding
+		 * 			the window along a row reuses the lines
+		 * 			already read.
+		 */
+		template <size_t R, size_t C>
+		void get_window(const coord_type x, const coord_type y,
+				data_type window[R][C],
+				const access_hint_type hint = INSERT_MRU) {
+#pragma HLS inline
+			static_assert((C <= PITCH), "C must not be greater than PITCH");
+
+			// the span of each row is kept inside the row,
+			// and the columns outside it are cleared
+			const coord_type max_span_x = (PITCH - C);
+			const coord_type span_x = ((x < 0) ? coord_type(0) :
+					((x > max_span_x) ? max_span_x : x));
+			for (size_t row = 0; row < R; row++) {
+				const coord_type row_y = (y + row);
+				const auto row_valid = ((row_y >= 0) &&
+						(row_y < coord_type(N_ROWS)));
+
+				data_type span[C];
+#pragma HLS array_partition variable=span type=complete dim=0
+				if (row_valid) {
+					m_cache->template get_span<C>(
+							to_addr_main(addr_main_type(span_x),
+								addr_main_type(row_y)),
+							(row % CACHE_TYPE::N_PORTS),
+							span, hint);
+				}
+
+				for (size_t col = 0; col < C; col++) {
+					const coord_type col_x = (x + col);
+					const auto col_valid = ((col_x >= 0) &&
+							(col_x < coord_type(PITCH)));
+					window[row][col] = ((row_valid && col_valid) ?
+							span[static_cast<size_t>(col_x - span_x)] :
+							data_type());
+				}
+			}
+		}
+};
+
 void init() {}
 
 template <typename HEAD_TYPE, typename... TAIL_TYPES>
@@ -879,6 +3801,67 @@ void cache_wrapper(T &&fn, ARGS_TYPES&&... args) {
 	stop(args...);
 }
 
+/**
+ * \brief	Tag selecting the decoupled version of \ref cache_wrapper.
+ */
+struct decoupled_type {};
+static const decoupled_type DECOUPLED = {};
+
+template <typename... ARGS_TYPES>
+struct has_read_write_cache : std::false_type {};
+
+template <typename HEAD_TYPE, typename... TAIL_TYPES>
+struct has_read_write_cache<HEAD_TYPE, TAIL_TYPES...> :
+	std::integral_constant<bool,
+	(is_read_write_cache<HEAD_TYPE>::value ||
+	 has_read_write_cache<TAIL_TYPES...>::value)> {};
+
+template <class GEN_TYPE, typename... ARGS_TYPES>
+void run_address_generator(GEN_TYPE &&gen, ARGS_TYPES&&... args) {
+#pragma HLS inline off
+	gen(args...);
+}
+
+/**
+ * \brief	Run \p fn on \p args, with the address generator \p gen
+ *		running ahead of it as a separate dataflow process.
+ *
+ *		\p gen takes the same arguments as \p fn and issues the
+ *		reads of \p fn with \ref cache::issue_get, while \p fn
+ *		consumes the responses with \ref cache::collect: the
+ *		generator runs ahead by up to LATENCY * PORTS reads per
+ *		port. Only read-only caches can be accessed by \p gen,
+ *		and they must not be accessed by \p fn on the same ports
+ *		other than through \ref cache::collect.
+ *
+ * \note	Read-write caches are rejected: the reads issued by \p gen
+ *		would not be ordered with the writes of \p fn. Write-only
+ *		caches can be accessed by \p fn only.
+ */
+template <class GEN_TYPE, class T, typename... ARGS_TYPES>
+void cache_wrapper(decoupled_type, GEN_TYPE &&gen, T &&fn,
+		ARGS_TYPES&&... args) {
+#pragma HLS inline off
+	static_assert(!has_read_write_cache<ARGS_TYPES...>::value,
+			"read-write caches cannot be accessed with decoupled address generation");
+#ifdef __SYNTHESIS__
+#pragma HLS dataflow
+	run_address_generator(gen, args...);
+	cache_wrapper(fn, args...);
+#else
+	init(args...);
+	std::thread gen_thread([&] {
+			is_decoupled_thread() = true;
+			gen(args...);
+			});
+	is_decoupled_thread() = true;
+	fn(args...);
+	is_decoupled_thread() = false;
+	gen_thread.join();
+	stop(args...);
+#endif /* __SYNTHESIS__ */
+}
+
 #pragma GCC diagnostic pop
 
 #endif /* CACHE_H */
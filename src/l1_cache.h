@@ -26,8 +26,7 @@ class l1_cache {
 		static const size_t N_LINES = (((N_SETS * N_WAYS) > 0) ?
 				(N_SETS * N_WAYS) : 1);
 
-		static_assert(((MAIN_SIZE > 0) && ((1 << ADDR_SIZE) == MAIN_SIZE)),
-				"MAIN_SIZE must be a power of 2 greater than 0");
+		static_assert((MAIN_SIZE > 0), "MAIN_SIZE must be greater than 0");
 		static_assert(((N_SETS == 0) || (1 << SET_SIZE) == N_SETS),
 				"N_SETS must be a power of 2");
 		static_assert(((N_WAYS == 0) || ((1 << WAY_SIZE) == N_WAYS)),
@@ -35,7 +34,8 @@ class l1_cache {
 		static_assert(((N_WORDS_PER_LINE > 0) &&
 					((1 << OFF_SIZE) == N_WORDS_PER_LINE)),
 				"N_WORDS_PER_LINE must be a power of 2 greater than 0");
-		static_assert((MAIN_SIZE >= (N_SETS * N_WAYS * N_WORDS_PER_LINE)),
+		static_assert(((static_cast<size_t>(1) << ADDR_SIZE) >=
+					(N_SETS * N_WAYS * N_WORDS_PER_LINE)),
 				"N_SETS and/or N_WAYS and/or N_WORDS_PER_LINE are too big for the specified MAIN_SIZE");
 
 		typedef WORD_TYPE line_type[N_WORDS_PER_LINE];
@@ -111,10 +111,13 @@ class l1_cache {
 
 		void notify_write(const ap_uint<ADDR_SIZE> addr_main) {
 #pragma HLS inline
-			const addr_type addr(addr_main);
+			addr_type addr(addr_main);
+			const auto way = hit(addr);
 
-			if (hit(addr) != -1)
+			if (way != -1) {
+				addr.set_way(way);
 				m_valid[addr.m_addr_line] = false;
+			}
 		}
 
 	private:
@@ -18,6 +18,84 @@
 #pragma GCC diagnostic error "-Wextra"
 #pragma GCC diagnostic ignored "-Wunused-label"
 
+/**
+ * \brief	Way partitioning policies: they return the ways in which the
+ *		lines missed by each port can be inserted (lookups always
+ *		search all the ways).
+ */
+
+/**
+ * \brief	No partitioning: all the ports insert lines in all the ways.
+ */
+struct no_way_partition {
+	template <size_t N_WAYS, size_t PORTS>
+	static ap_uint<N_WAYS> get_ways(const unsigned int port) {
+#pragma HLS inline
+		(void)port;
+		return ~ap_uint<N_WAYS>(0);
+	}
+};
+
+/**
+ * \brief	The ways are split evenly among the ports (with more ports
+ *		than ways, each group of ways is shared by the ports with
+ *		the same index modulo N_WAYS).
+ */
+struct even_way_partition {
+	template <size_t N_WAYS, size_t PORTS>
+	static ap_uint<N_WAYS> get_ways(const unsigned int port) {
+#pragma HLS inline
+		static const size_t N_GROUPS = ((PORTS < N_WAYS) ? PORTS : N_WAYS);
+		static const size_t N_WAYS_PER_GROUP = (N_WAYS / N_GROUPS);
+
+		// the last group takes the remaining ways
+		const auto group = (port % N_GROUPS);
+		ap_uint<N_WAYS> ways = 0;
+		for (size_t way = 0; way < N_WAYS; way++) {
+#pragma HLS unroll
+			const auto way_group = (way / N_WAYS_PER_GROUP);
+			ways[way] = ((way_group == group) ||
+					((way_group >= N_GROUPS) &&
+					 (group == (N_GROUPS - 1))));
+		}
+
+		return ways;
+	}
+};
+
+/**
+ * \brief	Explicit partitioning: port i inserts lines in the ways set
+ *		in \p WAY_MASKS[i % sizeof...(WAY_MASKS)], so that groups of
+ *		ports can share the same mask.
+ *
+ * \note	Each mask must have at least one of the lowest N_WAYS bits set.
+ */
+template <unsigned long long... WAY_MASKS>
+struct mask_way_partition {
+	static constexpr unsigned long long MASKS[sizeof...(WAY_MASKS)] =
+		{WAY_MASKS...};
+
+	// check that the masks from the i-th one select at least one way
+	static constexpr bool select_ways(const size_t n_ways,
+			const size_t i = 0) {
+		return ((i >= sizeof...(WAY_MASKS)) ||
+				(((MASKS[i] & ((n_ways >= 64) ? ~0ULL :
+					       ((1ULL << n_ways) - 1))) != 0) &&
+				 select_ways(n_ways, (i + 1))));
+	}
+
+	template <size_t N_WAYS, size_t PORTS>
+	static ap_uint<N_WAYS> get_ways(const unsigned int port) {
+#pragma HLS inline
+		static_assert(select_ways(N_WAYS),
+				"each mask must have at least one of the lowest N_WAYS bits set");
+		return ap_uint<N_WAYS>(MASKS[port % sizeof...(WAY_MASKS)]);
+	}
+};
+
+template <unsigned long long... WAY_MASKS>
+constexpr unsigned long long mask_way_partition<WAY_MASKS...>::MASKS[];
+
 template <bool LRU, typename ADDR_T, size_t N_SETS, size_t N_WAYS, size_t N_WORDS_PER_LINE>
 class replacer {
 	private:
@@ -81,29 +159,55 @@ class replacer {
 		}
 
 		/**
-		 * \brief	Update replacement policy data structures.
+		 * \brief		Update replacement policy data structures.
 		 *
-		 * \param addr	The address which has been inserted.
+		 * \param addr		The address which has been inserted.
+		 * \param low_priority	If true, the inserted way is left as
+		 * 			the next one to be replaced.
 		 */
-		void notify_insertion(const ADDR_T &addr) {
+		void notify_insertion(const ADDR_T &addr,
+				const bool low_priority = false) {
 #pragma HLS inline
 			if (!LRU) {
-				if (WAY_SIZE > 0)
+				if ((WAY_SIZE > 0) && !low_priority)
 					m_lifo[addr.m_set]++;
 			}
 		}
 
 		/**
-		 * \brief	Return the least recently used way associable
-		 * 		with \p addr.
+		 * \brief		Return the least recently used way
+		 * 			associable with \p addr.
 		 *
-		 * \param addr	The address to be associated.
+		 * \param addr		The address to be associated.
+		 * \param excluded	The ways which must not be returned
+		 * 			(at least one way must not be excluded).
 		 *
-		 * \return	The least recently used way.
+		 * \return		The least recently used way.
 		 */
-		inline int get_way(const ADDR_T &addr) const {
+		inline int get_way(const ADDR_T &addr,
+				const ap_uint<N_WAYS> excluded = 0) const {
 #pragma HLS inline
-			return (LRU ? m_lru[addr.m_set][0] : m_lifo[addr.m_set]);
+			if (LRU) {
+				// find the least recently used way not excluded
+				int lru_way = m_lru[addr.m_set][0];
+				for (int way = (N_WAYS - 1); way >= 0; way--) {
+					if (!excluded[m_lru[addr.m_set][way]])
+						lru_way = m_lru[addr.m_set][way];
+				}
+
+				return lru_way;
+			}
+
+			// find the first way not excluded, starting
+			// from the next one to be replaced
+			int lifo_way = m_lifo[addr.m_set];
+			for (int i = (N_WAYS - 1); i >= 0; i--) {
+				const auto way = ((m_lifo[addr.m_set] + i) % N_WAYS);
+				if (!excluded[way])
+					lifo_way = way;
+			}
+
+			return lifo_way;
 		}
 };
 
@@ -128,26 +232,34 @@ class replacer<LRU, ADDR_T, N_SETS, 1, N_WORDS_PER_LINE> {
 		}
 
 		/**
-		 * \brief	Update replacement policy data structures.
+		 * \brief		Update replacement policy data structures.
 		 *
-		 * \param addr	The address which has been inserted.
+		 * \param addr		The address which has been inserted.
+		 * \param low_priority	If true, the inserted way is left as
+		 * 			the next one to be replaced.
 		 */
-		void notify_insertion(const ADDR_T &addr) {
+		void notify_insertion(const ADDR_T &addr,
+				const bool low_priority = false) {
 #pragma HLS inline
 			(void)addr;
+			(void)low_priority;
 		}
 
 		/**
-		 * \brief	Return the least recently used way associable
-		 * 		with \p addr.
+		 * \brief		Return the least recently used way
+		 * 			associable with \p addr.
 		 *
-		 * \param addr	The address to be associated.
+		 * \param addr		The address to be associated.
+		 * \param excluded	The ways which must not be returned
+		 * 			(ignored, since there is only one way).
 		 *
-		 * \return	The least recently used way.
+		 * \return		The least recently used way.
 		 */
-		inline int get_way(const ADDR_T &addr) const {
+		inline int get_way(const ADDR_T &addr,
+				const ap_uint<1> excluded = 0) const {
 #pragma HLS inline
 			(void)addr;
+			(void)excluded;
 			return 0;
 		}
 };
@@ -15,6 +15,30 @@ namespace types {
 		BRAM,
 		AUTO
 	} storage_impl_type;
+
+	typedef enum {
+		INSERT_MRU,
+		INSERT_LRU,
+		NO_ALLOCATE
+	} access_hint_type;
+
+	typedef enum {
+		ROUND_ROBIN,
+		LINE_INTERLEAVED,
+		SET_INTERLEAVED
+	} port_policy_type;
+
+	typedef enum {
+		UPDATE_SET,
+		UPDATE_ADD,
+		UPDATE_SUB,
+		UPDATE_MIN,
+		UPDATE_MAX,
+		UPDATE_AND,
+		UPDATE_OR,
+		UPDATE_XOR,
+		UPDATE_CUSTOM
+	} update_op_type;
 }
 
 #pragma GCC diagnostic pop
@@ -0,0 +1,145 @@
+#ifndef UPDATE_H
+#define UPDATE_H
+
+#include <functional>
+#include "types.h"
+#include "utils.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic error "-Wpedantic"
+#pragma GCC diagnostic error "-Wall"
+#pragma GCC diagnostic error "-Wextra"
+#pragma GCC diagnostic ignored "-Wunused-label"
+
+/**
+ * \brief	Update policies.
+ *
+ *		A policy combines the stored word \p data with \p operand,
+ *		returning the word to be stored. The predefined policies
+ *		implement the operations of update_op_type, and any other
+ *		policy can be plugged in as the custom operation of a cache
+ *		(UPDATE_CUSTOM).
+ */
+
+/**
+ * \brief	The operand replaces the stored word.
+ */
+struct set_update {
+	template <typename T>
+	static T apply(const T data, const T operand) {
+#pragma HLS inline
+		(void)data;
+		return operand;
+	}
+};
+
+struct add_update {
+	template <typename T>
+	static T apply(const T data, const T operand) {
+#pragma HLS inline
+		return (data + operand);
+	}
+};
+
+struct sub_update {
+	template <typename T>
+	static T apply(const T data, const T operand) {
+#pragma HLS inline
+		return (data - operand);
+	}
+};
+
+struct min_update {
+	template <typename T>
+	static T apply(const T data, const T operand) {
+#pragma HLS inline
+		return ((operand < data) ? operand : data);
+	}
+};
+
+struct max_update {
+	template <typename T>
+	static T apply(const T data, const T operand) {
+#pragma HLS inline
+		return ((operand > data) ? operand : data);
+	}
+};
+
+/**
+ * \brief	Bitwise operations act on the bits of the word, whatever
+ *		its type.
+ */
+template <typename OP>
+struct bitwise_update {
+	template <typename T>
+	static T apply(const T data, const T operand) {
+#pragma HLS inline
+		union {
+			T word;
+			typename utils::raw_word<sizeof(T)>::type raw;
+		} conv_data, conv_operand;
+		conv_data.word = data;
+		conv_operand.word = operand;
+		conv_data.raw = OP()(conv_data.raw, conv_operand.raw);
+
+		return conv_data.word;
+	}
+};
+
+struct and_update : bitwise_update<std::bit_and<unsigned long long> > {};
+struct or_update : bitwise_update<std::bit_or<unsigned long long> > {};
+struct xor_update : bitwise_update<std::bit_xor<unsigned long long> > {};
+
+/**
+ * \brief		Apply the update policy of \p op.
+ *
+ * \param[in] op	The operation.
+ * \param[in] data	The stored word.
+ * \param[in] operand	The operand.
+ *
+ * \return		The word to be stored (\p CUSTOM_UPDATE is applied by
+ * 			UPDATE_CUSTOM).
+ */
+template <typename CUSTOM_UPDATE, typename T>
+T apply_update(const types::update_op_type op, const T data, const T operand) {
+#pragma HLS inline
+	switch (op) {
+		case types::UPDATE_ADD:
+			return add_update::apply(data, operand);
+		case types::UPDATE_SUB:
+			return sub_update::apply(data, operand);
+		case types::UPDATE_MIN:
+			return min_update::apply(data, operand);
+		case types::UPDATE_MAX:
+			return max_update::apply(data, operand);
+		case types::UPDATE_AND:
+			return and_update::apply(data, operand);
+		case types::UPDATE_OR:
+			return or_update::apply(data, operand);
+		case types::UPDATE_XOR:
+			return xor_update::apply(data, operand);
+		case types::UPDATE_CUSTOM:
+			return CUSTOM_UPDATE::apply(data, operand);
+		default:
+			return set_update::apply(data, operand);
+	}
+}
+
+/**
+ * \brief		Check if \p op is associative, so that it can be applied
+ * 			by a tree of operations.
+ *
+ * \param[in] op	The operation.
+ *
+ * \return		true for UPDATE_ADD, UPDATE_MIN, UPDATE_MAX, UPDATE_AND,
+ * 			UPDATE_OR and UPDATE_XOR.
+ */
+constexpr bool is_associative(const types::update_op_type op) {
+	return ((op == types::UPDATE_ADD) || (op == types::UPDATE_MIN) ||
+			(op == types::UPDATE_MAX) || (op == types::UPDATE_AND) ||
+			(op == types::UPDATE_OR) || (op == types::UPDATE_XOR));
+}
+
+#pragma GCC diagnostic pop
+
+#endif /* UPDATE_H */
@@ -1,6 +1,9 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <cstddef>
+#include <cstdint>
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic error "-Wpedantic"
 #pragma GCC diagnostic error "-Wall"
@@ -9,14 +12,28 @@
 #pragma GCC diagnostic ignored "-Wattributes"
 
 namespace utils {
-	constexpr unsigned log2_floor(const unsigned x) {
+	/**
+	 * \brief	Unsigned integer type with the same size of a
+	 * 		\p BYTES bytes word.
+	 */
+	template <size_t BYTES> struct raw_word {};
+	template <> struct raw_word<1> { typedef uint8_t type; };
+	template <> struct raw_word<2> { typedef uint16_t type; };
+	template <> struct raw_word<4> { typedef uint32_t type; };
+	template <> struct raw_word<8> { typedef uint64_t type; };
+
+	constexpr unsigned log2_floor(const unsigned long long x) {
 		    return ((x > 1) ? (1 + log2_floor(x >> 1)) : 0);
 	}
 
-	constexpr unsigned log2_ceil(const unsigned x) {
+	constexpr unsigned log2_ceil(const unsigned long long x) {
 		    return ((x > 1) ? (log2_floor(x - 1) + 1) : 0);
 	}
 
+	constexpr size_t div_ceil(const size_t x, const size_t y) {
+		return ((x + y - 1) / y);
+	}
+
 	constexpr int ceil(const float x) {
 		const int round = (int)x;
 		const int ceil_pos = (round < x) ? (round + 1) : round;
@@ -25,6 +42,24 @@ namespace utils {
 		return (x >= 0) ? ceil_pos : ceil_neg;
 	}
 
+	/**
+	 * \brief	Return the position of the least significant bit set
+	 * 		in the first \p N bits of \p bits.
+	 *
+	 * \return	-1 if no bit is set.
+	 */
+	template <size_t N, typename T>
+		int find_first(const T &bits) {
+#pragma HLS inline
+			int first = -1;
+			for (int i = (N - 1); i >= 0; i--) {
+				if (bits[i])
+					first = i;
+			}
+
+			return first;
+		}
+
 	template <size_t AMOUNT, typename T>
 		__attribute__((hls_preserve))
 		T delay(T data) {